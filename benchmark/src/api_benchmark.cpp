@@ -0,0 +1,306 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "benchmark/benchmark.h"
+#include "olfactory_device.h"
+#include "olfactory_device_defs.h"
+using namespace sony::olfactory_device;
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+#define BENCHMARK_DEVICE_JSON ("benchmark_device.json")
+#define BENCHMARK_DEVICES_MAX (4096)  // Largest number of devices measured
+#define BENCHMARK_SCHEDULE_LEAD_US (5000)  // Time between the scheduling of an emission and its time
+#define BENCHMARK_SCHEDULE_STEP_US (200)   // Time between the emissions of two devices
+
+// Returns the id of the device of the given index
+std::string DeviceId(int64_t index) {
+  return "bench" + std::to_string(index);
+}
+
+// Writes and loads a device.json with the given number of devices, each with its own address
+bool LoadDevices(int64_t devices, float cooldown) {
+  std::ofstream json_file(BENCHMARK_DEVICE_JSON);
+  json_file << R"({"device": [)";
+  for (int64_t i = 0; i < devices; i++) {
+    char ip[32];
+    std::snprintf(ip, sizeof(ip), "10.0.%d.%d", static_cast<int>(i / 256), static_cast<int>(i % 256));
+    json_file << (i == 0 ? "" : ",") << R"({"id": ")" << DeviceId(i) << R"(", "ip": ")" << ip
+              << R"(", "channels": [0, 1], "cooldown": )" << cooldown << R"(, "motor": 0})";
+  }
+  json_file << "]}";
+  json_file.close();
+  return sony_odLoadDeviceConfig(BENCHMARK_DEVICE_JSON) == OdResult::SUCCESS;
+}
+
+// Starts the sessions of all the devices of the benchmark, from the first thread only
+bool SetUpDevices(benchmark::State& state, float cooldown) {
+  if (state.thread_index() != 0) {
+    return true;
+  }
+  if (!LoadDevices(state.range(0), cooldown)) {
+    state.SkipWithError("Failed to load the device.json of the benchmark.");
+    return false;
+  }
+  for (int64_t i = 0; i < state.range(0); i++) {
+    sony_odStartSession(DeviceId(i).c_str());
+  }
+  return true;
+}
+
+// Ends the sessions started by SetUpDevices(), once all the threads have left the loop
+void TearDownDevices(benchmark::State& state) {
+  if (state.thread_index() != 0) {
+    return;
+  }
+  for (int64_t i = 0; i < state.range(0); i++) {
+    sony_odEndSession(DeviceId(i).c_str());
+  }
+  state.counters["devices"] = static_cast<double>(state.range(0));
+}
+
+// Each thread goes through the devices in turn, starting at its own index
+class DeviceCursor {
+ public:
+  explicit DeviceCursor(benchmark::State& state)
+      : devices_(state.range(0)), index_(state.thread_index() % state.range(0)) {
+    for (int64_t i = 0; i < devices_; i++) {
+      ids_.push_back(DeviceId(i));
+    }
+  }
+
+  const char* Next() {
+    const char* id = ids_[index_].c_str();
+    index_ = (index_ + 1) % devices_;
+    return id;
+  }
+
+ private:
+  int64_t devices_;
+  int64_t index_;
+  std::vector<std::string> ids_;
+};
+
+// Session start and end, the sessions of the other devices stay open
+void BM_StartEndSession(benchmark::State& state) {
+  if (!SetUpDevices(state, 0.0f)) {
+    return;
+  }
+  DeviceCursor cursor(state);
+  for (auto _ : state) {
+    const char* id = cursor.Next();
+    sony_odEndSession(id);
+    sony_odStartSession(id);
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownDevices(state);
+}
+BENCHMARK(BM_StartEndSession)->RangeMultiplier(16)->Range(1, BENCHMARK_DEVICES_MAX)->UseRealTime();
+
+// Start and end of all the sessions at once, with the given parallelism
+void BM_StartEndSessions(benchmark::State& state) {
+  if (!LoadDevices(state.range(0), 0.0f)) {
+    state.SkipWithError("Failed to load the device.json of the benchmark.");
+    return;
+  }
+  std::vector<std::string> ids;
+  std::vector<const char*> device_ids;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    ids.push_back(DeviceId(i));
+  }
+  for (const auto& id : ids) {
+    device_ids.push_back(id.c_str());
+  }
+  int32_t count = static_cast<int32_t>(device_ids.size());
+  int32_t parallelism = static_cast<int32_t>(state.range(1));
+  for (auto _ : state) {
+    sony_odStartSessions(device_ids.data(), count, parallelism, nullptr);
+    sony_odEndSessions(device_ids.data(), count, parallelism, nullptr);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_StartEndSessions)->ArgsProduct({{16, 256, BENCHMARK_DEVICES_MAX}, {1, 4, 16}})->UseRealTime();
+
+// Emission accepted on every call: no emission time and no cooldown
+void BM_StartScentEmission(benchmark::State& state) {
+  if (!SetUpDevices(state, 0.0f)) {
+    return;
+  }
+  DeviceCursor cursor(state);
+  bool is_available = false;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sony_odStartScentEmission(cursor.Next(), "0", 0.0f, is_available));
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownDevices(state);
+}
+BENCHMARK(BM_StartScentEmission)
+    ->RangeMultiplier(16)
+    ->Range(1, BENCHMARK_DEVICES_MAX)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Emission rejected on every call but the first one of each device, which starts a long cooldown
+void BM_StartScentEmissionRejected(benchmark::State& state) {
+  if (!SetUpDevices(state, 1000.0f)) {
+    return;
+  }
+  DeviceCursor cursor(state);
+  bool is_available = false;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sony_odStartScentEmission(cursor.Next(), "0", 0.0f, is_available));
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownDevices(state);
+}
+BENCHMARK(BM_StartScentEmissionRejected)
+    ->RangeMultiplier(16)
+    ->Range(1, BENCHMARK_DEVICES_MAX)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// One emission on every device, all in one call
+void BM_StartScentEmissions(benchmark::State& state) {
+  if (!SetUpDevices(state, 0.0f)) {
+    return;
+  }
+  std::vector<std::string> ids;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    ids.push_back(DeviceId(i));
+  }
+  std::vector<OdScentEmission> emissions;
+  for (const auto& id : ids) {
+    emissions.push_back({id.c_str(), 0, 0.0f});
+  }
+  int32_t count = static_cast<int32_t>(emissions.size());
+  std::unique_ptr<bool[]> is_available(new bool[count]);
+  std::vector<OdResult> results(count);
+  for (auto _ : state) {
+    sony_odStartScentEmissions(emissions.data(), count, 1, is_available.get(), results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  TearDownDevices(state);
+}
+BENCHMARK(BM_StartScentEmissions)->RangeMultiplier(16)->Range(16, BENCHMARK_DEVICES_MAX)->UseRealTime();
+
+void BM_IsScentEmissionAvailable(benchmark::State& state) {
+  if (!SetUpDevices(state, 0.0f)) {
+    return;
+  }
+  DeviceCursor cursor(state);
+  bool is_available = false;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sony_odIsScentEmissionAvailable(cursor.Next(), is_available));
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownDevices(state);
+}
+BENCHMARK(BM_IsScentEmissionAvailable)
+    ->RangeMultiplier(16)
+    ->Range(1, BENCHMARK_DEVICES_MAX)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Same query without resolving the device id
+void BM_IsScentEmissionAvailableByHandle(benchmark::State& state) {
+  if (!SetUpDevices(state, 0.0f)) {
+    return;
+  }
+  std::vector<int32_t> handles(state.range(0));
+  for (int64_t i = 0; i < state.range(0); i++) {
+    sony_odGetDeviceHandle(DeviceId(i).c_str(), handles[i]);
+  }
+  size_t index = state.thread_index() % handles.size();
+  bool is_available = false;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sony_odIsScentEmissionAvailableByHandle(handles[index], is_available));
+    index = (index + 1) % handles.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownDevices(state);
+}
+BENCHMARK(BM_IsScentEmissionAvailableByHandle)
+    ->RangeMultiplier(16)
+    ->Range(1, BENCHMARK_DEVICES_MAX)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+void BM_StopScentEmission(benchmark::State& state) {
+  if (!SetUpDevices(state, 0.0f)) {
+    return;
+  }
+  DeviceCursor cursor(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sony_odStopScentEmission(cursor.Next()));
+  }
+  state.SetItemsProcessed(state.iterations());
+  TearDownDevices(state);
+}
+BENCHMARK(BM_StopScentEmission)
+    ->RangeMultiplier(16)
+    ->Range(1, BENCHMARK_DEVICES_MAX)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// Delay of the scheduled emissions sent by the scheduler thread after their time. Each iteration schedules
+// one emission per device, spread over the following milliseconds, and waits until all of them are sent.
+void BM_ScheduledEmissionFiring(benchmark::State& state) {
+  if (!SetUpDevices(state, 0.0f)) {
+    return;
+  }
+  std::vector<int32_t> handles(state.range(0));
+  for (int64_t i = 0; i < state.range(0); i++) {
+    sony_odGetDeviceHandle(DeviceId(i).c_str(), handles[i]);
+  }
+  OdStats stats;
+  sony_odGetStats(stats, true);
+  bool is_available = false;
+  for (auto _ : state) {
+    int64_t now_us = 0;
+    sony_odGetTime(now_us);
+    int64_t time_us = now_us + BENCHMARK_SCHEDULE_LEAD_US;
+    for (int32_t handle : handles) {
+      sony_odScheduleScentEmissionByHandle(handle, 0, 0.0f, time_us, is_available);
+      time_us += BENCHMARK_SCHEDULE_STEP_US;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(time_us - now_us + BENCHMARK_SCHEDULE_LEAD_US));
+  }
+  sony_odGetStats(stats, false);
+  const OdLatencyStats& firing = stats.latency[static_cast<int32_t>(OdStatsApi::SCHEDULED_FIRING)];
+  state.counters["fired"] = static_cast<double>(firing.count);
+  state.counters["p50_us"] = firing.p50_ns / 1000.0;
+  state.counters["p99_us"] = firing.p99_ns / 1000.0;
+  state.counters["p999_us"] = firing.p999_ns / 1000.0;
+  state.counters["max_us"] = firing.max_ns / 1000.0;
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  TearDownDevices(state);
+}
+BENCHMARK(BM_ScheduledEmissionFiring)->RangeMultiplier(4)->Range(1, 64)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,100 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "benchmark/benchmark.h"
+#include "frame_receiver.h"
+using namespace sony::olfactory_device;
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Replies of a device as sent on the wire, about 1 MiB in total
+std::string MakeStream(FrameMode mode) {
+  std::string stream;
+  for (int i = 0; stream.size() < (1 << 20); i++) {
+    std::string reply = "ok(" + std::to_string(i % 64) + "," + std::to_string(i) + ")";
+    if (mode == FrameMode::NEWLINE) {
+      stream += reply + "\r\n";
+    } else {
+      stream += static_cast<char>(reply.size() >> 8);
+      stream += static_cast<char>(reply.size() & 0xff);
+      stream += reply;
+    }
+  }
+  return stream;
+}
+
+// Frames reassembled in place from reads of range(0) bytes
+void BM_FrameReceiver(benchmark::State& state, FrameMode mode) {
+  std::string stream = MakeStream(mode);
+  size_t read_size = static_cast<size_t>(state.range(0));
+  FrameReceiver receiver(mode);
+  int64_t frames = 0;
+  for (auto _ : state) {
+    for (size_t offset = 0; offset < stream.size();) {
+      size_t size = 0;
+      char* buffer = receiver.WritePointer(size);
+      size = std::min({size, read_size, stream.size() - offset});
+      memcpy(buffer, stream.data() + offset, size);
+      receiver.Commit(size);
+      offset += size;
+      std::string_view frame;
+      while (receiver.Next(frame)) {
+        benchmark::DoNotOptimize(frame.data());
+        frames++;
+      }
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * stream.size());
+  state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_FrameReceiver, newline, FrameMode::NEWLINE)->RangeMultiplier(8)->Range(16, 4096);
+BENCHMARK_CAPTURE(BM_FrameReceiver, length_prefixed, FrameMode::LENGTH_PREFIXED)
+    ->RangeMultiplier(8)
+    ->Range(16, 4096);
+
+// Previous receive path: a std::string per read, lines split by copying them out of an accumulated string
+void BM_StringLineSplit(benchmark::State& state) {
+  std::string stream = MakeStream(FrameMode::NEWLINE);
+  size_t read_size = static_cast<size_t>(state.range(0));
+  int64_t frames = 0;
+  std::string pending;
+  for (auto _ : state) {
+    for (size_t offset = 0; offset < stream.size(); offset += read_size) {
+      std::string data = stream.substr(offset, read_size);
+      pending += data;
+      size_t newline;
+      while ((newline = pending.find('\n')) != std::string::npos) {
+        std::string frame = pending.substr(0, newline);
+        benchmark::DoNotOptimize(frame.data());
+        pending.erase(0, newline + 1);
+        frames++;
+      }
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * stream.size());
+  state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_StringLineSplit)->RangeMultiplier(8)->Range(16, 4096);
+
+}  // namespace
@@ -0,0 +1,50 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "benchmark/benchmark.h"
+#include "olfactory_device.h"
+#include "olfactory_device_defs.h"
+#include "async_log.h"
+using namespace sony::olfactory_device;
+
+namespace {
+
+// Discards the log messages, only their cost on the calling thread is measured
+void DiscardLogCallback(const char* /*message*/, OdLogLevel /*level*/) {}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // Keep the console output of the library and of the session classes built into this executable
+  // out of the measured calls
+  sony_odRegisterAsyncLogCallback(DiscardLogCallback, OdLogLevel::OFF);
+  AsyncLog::GetInstance().Start(DiscardLogCallback, OdLogLevel::OFF);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  AsyncLog::GetInstance().Stop();
+  sony_odRegisterAsyncLogCallback(nullptr, OdLogLevel::OFF);
+  return 0;
+}
@@ -0,0 +1,212 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "benchmark/benchmark.h"
+#include "osc_session.h"
+#include "udp_transmit_batch.h"
+#include "uring_session.h"
+using namespace sony::olfactory_device;
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Receives the packets sent by OscSession on the loopback interface
+class LoopbackReceiver : public PacketListener {
+ public:
+  LoopbackReceiver()
+      : socket_(IpEndpointName("127.0.0.1", OSC_PORT), this), thread_([this]() { socket_.Run(); }) {}
+
+  ~LoopbackReceiver() {
+    socket_.AsynchronousBreak();
+    thread_.join();
+  }
+
+  void ProcessPacket(const char* /*data*/, int /*size*/, const IpEndpointName& /*remote_endpoint*/) override {
+    received++;
+  }
+
+  std::atomic<int64_t> received{0};
+
+ private:
+  UdpListeningReceiveSocket socket_;
+  std::thread thread_;
+};
+
+// The bundle of one release command, as sent by OscSession::SendData()
+struct ReleasePacket {
+  char buffer[1024] = {0};
+  osc::OutboundPacketStream stream{buffer, sizeof(buffer) - 1};
+
+  ReleasePacket() {
+    stream << osc::BeginBundleImmediate << osc::BeginMessage("/scent") << "release" << 0 << 0
+           << osc::EndMessage << osc::EndBundle;
+  }
+};
+
+// Baseline: a socket created and closed for every command, as OscSession::SendData() used to do
+void BM_OscSendSocketPerCommand(benchmark::State& state) {
+  LoopbackReceiver receiver;
+  ReleasePacket packet;
+  for (auto _ : state) {
+    UdpTransmitSocket socket(IpEndpointName("127.0.0.1", OSC_PORT));
+    socket.Send(packet.stream.Data(), packet.stream.Size());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["received"] = static_cast<double>(receiver.received);
+}
+BENCHMARK(BM_OscSendSocketPerCommand)->UseRealTime();
+
+// A socket kept open for the whole session, as OscSession does now
+void BM_OscSendPersistentSocket(benchmark::State& state) {
+  LoopbackReceiver receiver;
+  ReleasePacket packet;
+  UdpTransmitSocket socket(IpEndpointName("127.0.0.1", OSC_PORT));
+  for (auto _ : state) {
+    socket.Send(packet.stream.Data(), packet.stream.Size());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["received"] = static_cast<double>(receiver.received);
+}
+BENCHMARK(BM_OscSendPersistentSocket)->UseRealTime();
+
+// One command per datagram
+void BM_OscSendData(benchmark::State& state) {
+  LoopbackReceiver receiver;
+  OscSession session;
+  if (!session.Open("127.0.0.1")) {
+    state.SkipWithError("Failed to open the OSC session.");
+    return;
+  }
+  DeviceCommand command = {CommandOpcode::RELEASE, 0, 0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(session.SendData(command));
+  }
+  session.Close();
+  state.SetItemsProcessed(state.iterations());
+  state.counters["received"] = static_cast<double>(receiver.received);
+}
+BENCHMARK(BM_OscSendData)->UseRealTime();
+
+// Commands packed into bundles of up to one datagram each
+void BM_OscSendDataBatch(benchmark::State& state) {
+  LoopbackReceiver receiver;
+  OscSession session;
+  if (!session.Open("127.0.0.1")) {
+    state.SkipWithError("Failed to open the OSC session.");
+    return;
+  }
+  std::vector<DeviceCommand> commands(state.range(0), {CommandOpcode::RELEASE, 0, 0});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(session.SendDataBatch(commands));
+  }
+  session.Close();
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["received"] = static_cast<double>(receiver.received);
+}
+BENCHMARK(BM_OscSendDataBatch)->RangeMultiplier(8)->Range(1, 1024)->UseRealTime();
+
+
+// Opens one session per device, all of them sending to the loopback receiver
+bool OpenFleet(benchmark::State& state, std::vector<std::unique_ptr<OscSession>>& sessions) {
+  for (int64_t i = 0; i < state.range(0); i++) {
+    sessions.push_back(std::make_unique<OscSession>());
+    if (!sessions.back()->Open("127.0.0.1")) {
+      state.SkipWithError("Failed to open the OSC session.");
+      return false;
+    }
+  }
+  return true;
+}
+
+// One command to each device, one system call per datagram
+void BM_OscSendDataFleet(benchmark::State& state) {
+  LoopbackReceiver receiver;
+  std::vector<std::unique_ptr<OscSession>> sessions;
+  if (!OpenFleet(state, sessions)) {
+    return;
+  }
+  DeviceCommand command = {CommandOpcode::RELEASE, 0, 0};
+  for (auto _ : state) {
+    for (auto& session : sessions) {
+      benchmark::DoNotOptimize(session->SendData(command));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["received"] = static_cast<double>(receiver.received);
+}
+BENCHMARK(BM_OscSendDataFleet)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime();
+
+// One command to each device, all the datagrams sent by UdpTransmitBatch::Flush()
+void BM_OscSendDataFleetBatch(benchmark::State& state) {
+  LoopbackReceiver receiver;
+  std::vector<std::unique_ptr<OscSession>> sessions;
+  if (!OpenFleet(state, sessions)) {
+    return;
+  }
+  DeviceCommand command = {CommandOpcode::RELEASE, 0, 0};
+  UdpTransmitBatch batch;
+  for (auto _ : state) {
+    {
+      UdpTransmitBatch::Scope scope(batch);
+      for (auto& session : sessions) {
+        benchmark::DoNotOptimize(session->SendData(command));
+      }
+    }
+    benchmark::DoNotOptimize(batch.Flush());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["received"] = static_cast<double>(receiver.received);
+}
+BENCHMARK(BM_OscSendDataFleetBatch)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime();
+
+
+#ifdef __linux__
+// One command to each device, submitted through io_uring without waiting for the sends to complete
+void BM_UringSendDataFleet(benchmark::State& state) {
+  LoopbackReceiver receiver;
+  std::vector<std::unique_ptr<UringSession>> sessions;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    sessions.push_back(std::make_unique<UringSession>());
+    if (!sessions.back()->Open("127.0.0.1")) {
+      state.SkipWithError("Failed to open the io_uring session.");
+      return;
+    }
+  }
+  DeviceCommand command = {CommandOpcode::RELEASE, 0, 0};
+  for (auto _ : state) {
+    for (auto& session : sessions) {
+      benchmark::DoNotOptimize(session->SendData(command));
+    }
+  }
+  // Closing waits for the sends in flight
+  for (auto& session : sessions) {
+    session->Close();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["received"] = static_cast<double>(receiver.received);
+}
+BENCHMARK(BM_UringSendDataFleet)->RangeMultiplier(8)->Range(8, 4096)->UseRealTime();
+#endif
+
+}  // namespace
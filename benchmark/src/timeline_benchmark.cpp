@@ -0,0 +1,91 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "benchmark/benchmark.h"
+#include "timeline_file.h"
+using namespace sony::olfactory_device;
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Writes a timeline of range(0) events, one every 10 ms on 16 devices, and returns its path
+std::string MakeTimeline(int64_t count) {
+  std::string path = "timeline_benchmark_" + std::to_string(count) + ".odtl";
+  std::vector<TimelineEntry> entries;
+  entries.reserve(count);
+  for (int64_t i = 0; i < count; i++) {
+    entries.push_back({i * 10000, "device" + std::to_string(i % 16), static_cast<int32_t>(i % 8), 1.0f});
+  }
+  TimelineFile::Write(path.c_str(), entries);
+  return path;
+}
+
+// Opening a mapped timeline, independent of its length
+void BM_TimelineOpen(benchmark::State& state) {
+  std::string path = MakeTimeline(state.range(0));
+  TimelineFile file;
+  for (auto _ : state) {
+    file.Open(path.c_str());
+    benchmark::DoNotOptimize(file.Count());
+    file.Close();
+  }
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_TimelineOpen)->RangeMultiplier(10)->Range(10000, 1000000);
+
+// Baseline: reading the whole timeline into memory before playing it
+void BM_TimelineLoad(benchmark::State& state) {
+  std::string path = MakeTimeline(state.range(0));
+  std::vector<TimelineRecord> records;
+  for (auto _ : state) {
+    std::ifstream stream(path, std::ios::binary);
+    TimelineHeader header;
+    stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+    records.resize(header.event_count);
+    stream.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TimelineRecord));
+    benchmark::DoNotOptimize(records.data());
+  }
+  std::remove(path.c_str());
+}
+BENCHMARK(BM_TimelineLoad)->RangeMultiplier(10)->Range(10000, 1000000);
+
+// Seek to a random position through the time index
+void BM_TimelineSeek(benchmark::State& state) {
+  std::string path = MakeTimeline(state.range(0));
+  TimelineFile file;
+  file.Open(path.c_str());
+  std::mt19937 random(25);
+  std::uniform_int_distribution<int64_t> positions(0, file.Duration());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(file.Seek(positions(random)));
+  }
+  file.Close();
+  std::remove(path.c_str());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimelineSeek)->RangeMultiplier(10)->Range(10000, 1000000);
+
+}  // namespace
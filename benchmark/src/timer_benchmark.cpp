@@ -0,0 +1,142 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "benchmark/benchmark.h"
+#include "timing_wheel.h"
+using namespace sony::olfactory_device;
+
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Timers of the benchmarks: a device handle and a channel, as in AvailabilityNotifier
+struct Timer {
+  int32_t handle;
+  int32_t channel;
+};
+
+// Event of the heap baseline, the structure used before the timing wheel
+struct HeapTimer {
+  std::chrono::steady_clock::time_point time;
+  Timer timer;
+
+  bool operator>(const HeapTimer& other) const { return time > other.time; }
+};
+
+// Delays of the timers in milliseconds, spread so that range(0) timers are active on average. Up to 1M
+// active timers the delays stay below 35 minutes, like the cooldowns.
+std::vector<int64_t> MakeDelays(int64_t active) {
+  std::mt19937 random(24);
+  std::uniform_int_distribution<int64_t> delays(1, 2 * active);
+  std::vector<int64_t> values(1 << 16);
+  for (auto& value : values) {
+    value = delays(random);
+  }
+  return values;
+}
+
+// One simulated millisecond per iteration: one timer added, the clock moved, the due timers expired.
+// range(0) timers are active in the steady state.
+void BM_TimingWheel(benchmark::State& state) {
+  std::vector<int64_t> delays = MakeDelays(state.range(0));
+  auto origin = std::chrono::steady_clock::time_point();
+  TimingWheel<Timer> wheel(origin);
+  int64_t now_ms = 0;
+  size_t next = 0;
+  int64_t expired = 0;
+  auto count = [&expired](TimingWheel<Timer>::TimerId, const Timer&) { expired++; };
+
+  // Fill the wheel up to its steady state before measuring
+  for (int64_t i = 0; i < 2 * state.range(0); i++, now_ms++) {
+    wheel.Add(origin + std::chrono::milliseconds(now_ms + delays[next++ & 0xffff]), {0, 0},
+              origin + std::chrono::milliseconds(now_ms));
+    wheel.Advance(origin + std::chrono::milliseconds(now_ms), count);
+  }
+  expired = 0;
+  for (auto _ : state) {
+    wheel.Add(origin + std::chrono::milliseconds(now_ms + delays[next++ & 0xffff]), {0, 0},
+              origin + std::chrono::milliseconds(now_ms));
+    wheel.Advance(origin + std::chrono::milliseconds(now_ms), count);
+    now_ms++;
+  }
+  state.counters["active"] = static_cast<double>(wheel.Size());
+  state.counters["expired"] = static_cast<double>(expired);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimingWheel)->RangeMultiplier(10)->Range(10000, 1000000);
+
+// Same simulation with a binary heap
+void BM_TimerHeap(benchmark::State& state) {
+  std::vector<int64_t> delays = MakeDelays(state.range(0));
+  auto origin = std::chrono::steady_clock::time_point();
+  std::priority_queue<HeapTimer, std::vector<HeapTimer>, std::greater<HeapTimer>> heap;
+  int64_t now_ms = 0;
+  size_t next = 0;
+  int64_t expired = 0;
+  auto advance = [&]() {
+    auto now = origin + std::chrono::milliseconds(now_ms);
+    while (!heap.empty() && heap.top().time <= now) {
+      heap.pop();
+      expired++;
+    }
+  };
+
+  for (int64_t i = 0; i < 2 * state.range(0); i++, now_ms++) {
+    heap.push({origin + std::chrono::milliseconds(now_ms + delays[next++ & 0xffff]), {0, 0}});
+    advance();
+  }
+  expired = 0;
+  for (auto _ : state) {
+    heap.push({origin + std::chrono::milliseconds(now_ms + delays[next++ & 0xffff]), {0, 0}});
+    advance();
+    now_ms++;
+  }
+  state.counters["active"] = static_cast<double>(heap.size());
+  state.counters["expired"] = static_cast<double>(expired);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimerHeap)->RangeMultiplier(10)->Range(10000, 1000000);
+
+// Cancellation of a timer among range(0) active ones, as done when an emission is stopped. The heap
+// has no cancellation, the cancelled timers would stay until they expire.
+void BM_TimingWheelCancel(benchmark::State& state) {
+  std::vector<int64_t> delays = MakeDelays(state.range(0));
+  auto origin = std::chrono::steady_clock::time_point();
+  TimingWheel<Timer> wheel(origin);
+  std::vector<TimingWheel<Timer>::TimerId> ids;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    ids.push_back(wheel.Add(origin + std::chrono::milliseconds(delays[i & 0xffff]), {0, 0}, origin));
+  }
+  size_t index = 0;
+  for (auto _ : state) {
+    wheel.Cancel(ids[index]);
+    ids[index] = wheel.Add(origin + std::chrono::milliseconds(delays[index & 0xffff]), {0, 0}, origin);
+    index = (index + 1) % ids.size();
+  }
+  state.counters["active"] = static_cast<double>(wheel.Size());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimingWheelCancel)->RangeMultiplier(10)->Range(10000, 1000000);
+
+}  // namespace
@@ -0,0 +1,113 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "benchmark/benchmark.h"
+#include "uart_protocol.h"
+#include "uart_write_queue.h"
+using namespace sony::olfactory_device;
+
+#define UART_LINK_BYTES_PER_SECOND (11520.0)  // 115200 baud, 10 bits per byte with 8N1
+
+namespace {
+
+// Encoding of the commands, and the rate of commands the serial link sustains with the encoded size
+void BM_UartEncode(benchmark::State& state, UartProtocol protocol) {
+  char buffer[UART_WRITE_ENTRY_MAX];
+  int64_t bytes = 0;
+  int32_t i = 0;
+  for (auto _ : state) {
+    DeviceCommand command = {CommandOpcode::RELEASE, i & 0xff, 3 + (i & 0x1f)};
+    int length = EncodeCommand(protocol, command, static_cast<uint8_t>(i), buffer, sizeof(buffer));
+    benchmark::DoNotOptimize(buffer);
+    bytes += length;
+    i++;
+  }
+  double bytes_per_command = static_cast<double>(bytes) / static_cast<double>(state.iterations());
+  state.SetItemsProcessed(state.iterations());
+  state.counters["bytes/command"] = bytes_per_command;
+  state.counters["link_commands/s"] = UART_LINK_BYTES_PER_SECOND / bytes_per_command;
+}
+BENCHMARK_CAPTURE(BM_UartEncode, text, UartProtocol::TEXT);
+BENCHMARK_CAPTURE(BM_UartEncode, binary, UartProtocol::BINARY);
+
+}  // namespace
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Bursts of range(0) commands written to /dev/null, which leaves only the cost of the write calls
+
+// Previous write path: one write per command on the caller's thread
+void BM_UartWriteDirect(benchmark::State& state) {
+  int fd = open("/dev/null", O_WRONLY);
+  char buffer[UART_WRITE_ENTRY_MAX];
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); i++) {
+      int length = FormatCommand({CommandOpcode::RELEASE, static_cast<int32_t>(i), 3}, buffer, sizeof(buffer));
+      benchmark::DoNotOptimize(write(fd, buffer, length));
+    }
+  }
+  close(fd);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UartWriteDirect)->RangeMultiplier(8)->Range(1, 512)->UseRealTime();
+
+// Commands queued by the caller and coalesced by the writer thread, waiting for the whole burst
+void BM_UartWriteQueue(benchmark::State& state) {
+  int fd = open("/dev/null", O_WRONLY);
+  int64_t writes = 0;
+  UartWriteQueue queue([fd, &writes](const char* data, size_t size) {
+    writes++;
+    return write(fd, data, size) == static_cast<ssize_t>(size);
+  });
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); i++) {
+      queue.Push({CommandOpcode::RELEASE, static_cast<int32_t>(i), 3});
+    }
+    queue.Flush();
+  }
+  queue.Stop();
+  close(fd);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["commands/write"] =
+      static_cast<double>(state.iterations() * state.range(0)) / static_cast<double>(writes);
+}
+BENCHMARK(BM_UartWriteQueue)->RangeMultiplier(8)->Range(1, 512)->UseRealTime();
+
+// Time spent by the caller only, the writes happen in the background
+void BM_UartWriteQueuePush(benchmark::State& state) {
+  int fd = open("/dev/null", O_WRONLY);
+  UartWriteQueue queue([fd](const char* data, size_t size) {
+    return write(fd, data, size) == static_cast<ssize_t>(size);
+  });
+  for (auto _ : state) {
+    queue.Push({CommandOpcode::RELEASE, 0, 3});
+  }
+  queue.Stop();
+  close(fd);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UartWriteQueuePush)->UseRealTime();
+
+}  // namespace
+#endif  // __linux__
@@ -0,0 +1,21 @@
+#!/bin/sh
+# Linux counterpart of build_third_party_vs2022.bat
+set -e
+
+PROJECT_DIR="$(cd "$(dirname "$0")" && pwd)/third_party/oscpack"
+
+BUILD_DIR="$PROJECT_DIR/build"
+if [ -d "$BUILD_DIR" ]; then
+    echo "Removing existing build directory..."
+    rm -rf "$BUILD_DIR"
+fi
+
+mkdir "$BUILD_DIR"
+cd "$BUILD_DIR"
+
+# liboscpack.a is linked into libolfactory_device.so, so it must be position independent
+cmake -DCMAKE_BUILD_TYPE=Release -DCMAKE_POSITION_INDEPENDENT_CODE=ON ..
+
+cmake --build . --target oscpack
+
+echo "Build complete."
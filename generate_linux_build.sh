@@ -0,0 +1,28 @@
+#!/bin/sh
+# Linux counterpart of generate_vs_solution_2022.bat
+set -e
+cd "$(dirname "$0")"
+
+rm -rf build install
+mkdir build
+
+VCPKG_TARGET_TRIPLET=x64-linux
+cp -r third_party/ai-sdk-vcpkg-ports/ports/. third_party/vcpkg/ports/
+
+(
+  cd third_party/vcpkg
+  ./bootstrap-vcpkg.sh
+  ./vcpkg install "log-settings:$VCPKG_TARGET_TRIPLET"
+  ./vcpkg install "benchmark:$VCPKG_TARGET_TRIPLET"
+)
+
+echo "===== Start building third party libraries. ====="
+sh build_third_party_linux.sh
+echo "===== End building third party libraries. ====="
+
+cmake -S . -B build \
+  -DCMAKE_BUILD_TYPE=Release \
+  -DCMAKE_TOOLCHAIN_FILE=third_party/vcpkg/scripts/buildsystems/vcpkg.cmake \
+  -DVCPKG_TARGET_TRIPLET="$VCPKG_TARGET_TRIPLET"
+
+echo "===== Configuring the Linux build completed. Build with: cmake --build build ====="
@@ -17,6 +17,7 @@ xcopy /I /E /Y third_party\ai-sdk-vcpkg-ports\ports third_party\vcpkg\ports
 pushd third_party\vcpkg
 CALL bootstrap-vcpkg.bat
 vcpkg install log-settings:%VCPKG_TARGET_TRIPLET%
+vcpkg install benchmark:%VCPKG_TARGET_TRIPLET%
 popd
 
 pushd build
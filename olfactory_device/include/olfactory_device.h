@@ -47,8 +47,58 @@ namespace sony::olfactory_device {
  */
 OLFACTORY_DEVICE_API OdResult sony_odRegisterLogCallback(OdLogCallback callback);
 
+/**
+ * @brief Register a log callback function called from a background thread
+ *
+ * The log messages are queued in a fixed-size buffer and formatted and delivered by a background thread,
+ * so that logging never blocks the API calls. The console output of the sessions goes through the same
+ * thread. Messages are dropped when the buffer is full, and the number of dropped messages is reported
+ * with a WARN message. Call this function with nullptr before unloading the library.
+ *
+ * @param[in] callback The callback function to be called with log messages and their levels, or nullptr
+ * to stop the background thread
+ * @param[in] level The lowest level to log. Messages below it are discarded before being formatted.
+ * @return OdResult Returns SUCCESS if the callback is registered successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odRegisterAsyncLogCallback(OdLogCallback callback, OdLogLevel level);
+
+/**
+ * @brief Get the latency statistics of the API calls and the counters of the library
+ *
+ * The latencies are measured for each OdStatsApi, on every call, and the percentiles are accurate to
+ * 12.5%. The statistics cover the calls since the library was loaded or since the last reset.
+ * Only the first stats.size bytes are written, stats.size being set by the constructor of OdStats.
+ *
+ * @param[in,out] stats The statistics
+ * @param[in] reset True to start the next statistics from now
+ * @return OdResult Returns SUCCESS if the statistics are read successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odGetStats(OdStats& stats, bool reset);
+
+/**
+ * @brief Get the current time of the clock used by the scheduled emissions
+ *
+ * The clock is monotonic and its origin is unspecified, so only differences between its times are
+ * meaningful.
+ *
+ * @param[out] time_us The current time in microseconds
+ * @return OdResult Returns SUCCESS
+ */
+OLFACTORY_DEVICE_API OdResult sony_odGetTime(int64_t& time_us);
+
+/**
+ * @brief Load (or reload) the device configuration
+ * @param[in] json_path The path of device.json to load, or nullptr to load the installed device.json
+ * @return OdResult Returns SUCCESS if the configuration is loaded successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odLoadDeviceConfig(const char* json_path);
+
 /**
  * @brief Start a session for the specified device
+ *
+ * A serial device with "protocol": "binary" in device.json is asked to switch to binary frames, and
+ * stays in text if it refuses.
+ *
  * @param[in] device_id The UART port number (e.g., "COM3") representing the device
  * @return OdResult Returns SUCCESS if the session starts successfully, otherwise ERROR_UNKNOWN
  */
@@ -61,6 +111,36 @@ OLFACTORY_DEVICE_API OdResult sony_odStartSession(const char* device_id);
  */
 OLFACTORY_DEVICE_API OdResult sony_odEndSession(const char* device_id);
 
+/**
+ * @brief Start the sessions of several devices concurrently
+ *
+ * Each device is opened and initialized as by sony_odStartSession. Up to parallelism devices are
+ * processed at the same time, so that slow devices do not delay the others.
+ *
+ * @param[in] device_ids The ids of the devices
+ * @param[in] count The number of devices
+ * @param[in] parallelism The maximum number of devices processed at the same time, 0 for the default (16)
+ * @param[out] results The result of each device, may be nullptr
+ * @return OdResult Returns SUCCESS if all the sessions start successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odStartSessions(const char* const* device_ids, int32_t count,
+                                                   int32_t parallelism, OdResult* results);
+
+/**
+ * @brief End the sessions of several devices concurrently
+ *
+ * Each session is ended as by sony_odEndSession. Up to parallelism devices are processed at the same
+ * time.
+ *
+ * @param[in] device_ids The ids of the devices
+ * @param[in] count The number of devices
+ * @param[in] parallelism The maximum number of devices processed at the same time, 0 for the default (16)
+ * @param[out] results The result of each device, may be nullptr
+ * @return OdResult Returns SUCCESS if all the sessions end successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odEndSessions(const char* const* device_ids, int32_t count,
+                                                 int32_t parallelism, OdResult* results);
+
 
 /**
  * @brief Set the orientation of the scent emission for the specified device
@@ -76,7 +156,8 @@ OLFACTORY_DEVICE_API OdResult sony_odSetScentOrientation(const char* device_id,
  * @param[in] device_id The UART port number (e.g., "COM3") representing the device
  * @param[in] scent_name The name of the scent to emit
  * @param[in] duration The duration of emission
- * @param[out] is_available A boolean flag set to true if scent emission is available, false otherwise
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false otherwise. It is
+ * false after an emission is sent, since the scent is unavailable until its cooldown ends
  * @return OdResult Returns SUCCESS if the scent emission starts successfully, otherwise ERROR_UNKNOWN
  */
 OLFACTORY_DEVICE_API OdResult sony_odStartScentEmission(const char* device_id, const char* scent_name,
@@ -84,11 +165,78 @@ OLFACTORY_DEVICE_API OdResult sony_odStartScentEmission(const char* device_id, c
 
 /**
  * @brief Stop scent emission for the specified device
+ *
+ * The emissions scheduled by sony_odScheduleScentEmission and not sent yet are cancelled, and their scents
+ * are available again. Emissions already sent to a device with an OSC time tag cannot be recalled.
+ *
  * @param[in] device_id The UART port number (e.g., "COM3") representing the device
  * @return OdResult Returns SUCCESS if the scent emission stops successfully, otherwise ERROR_UNKNOWN
  */
 OLFACTORY_DEVICE_API OdResult sony_odStopScentEmission(const char* device_id);
 
+/**
+ * @brief Start scent emissions on several devices in one call
+ *
+ * The cooldowns of each device are checked in one pass, and the accepted emissions of a device are sent
+ * in one transmission. A scent requested twice for the same device is rejected the second time. The OSC
+ * packets of all the devices are sent together before the devices are released to the other calls, and an
+ * emission whose packet could not be sent fails.
+ *
+ * @param[in] emissions The emissions to start
+ * @param[in] count The number of emissions
+ * @param[in] parallelism The maximum number of devices sent to at the same time, 0 for the default (1)
+ * @param[out] is_available The array set to true for each emission which was sent, false if its scent
+ * was still unavailable or the emission failed
+ * @param[out] results The array set to the result of each emission. A rejected emission is a SUCCESS.
+ * @return OdResult Returns SUCCESS if every emission has a SUCCESS result, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odStartScentEmissions(const OdScentEmission* emissions, int32_t count,
+                                                         int32_t parallelism, bool* is_available,
+                                                         OdResult* results);
+
+/**
+ * @brief Start scent emissions on several devices at the same instant
+ *
+ * The commands of every device are checked and staged first, holding all the devices, and then released
+ * together. If every released device has "timetags": true in device.json, they all receive an OSC bundle
+ * carrying the same time, shortly after the release. Otherwise the commands are sent back to back, the OSC
+ * packets in one flush. The skew measured by the library is reported in group.
+ *
+ * @param[in] emissions The emissions to start
+ * @param[in] count The number of emissions
+ * @param[out] is_available The array set to true for each emission which was sent, false if its scent
+ * was still unavailable or the emission failed
+ * @param[out] results The array set to the result of each emission. A rejected emission is a SUCCESS.
+ * @param[out] group The start time and the skew of the released devices
+ * @return OdResult Returns SUCCESS if every emission has a SUCCESS result, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odStartGroupScentEmission(const OdScentEmission* emissions, int32_t count,
+                                                             bool* is_available, OdResult* results,
+                                                             OdGroupEmission& group);
+
+/**
+ * @brief Schedule a scent emission for the specified device at a future time
+ *
+ * Devices with "timetags": true in device.json receive the command immediately in an OSC bundle carrying
+ * the time, and fire it exactly at that time. For the other devices, the command is sent at the time by
+ * a scheduler thread of the library. The scent is unavailable from the call until the end of the cooldown
+ * of the scheduled emission. A time in the past starts the emission immediately. Stopping the emission
+ * or ending the session cancels the emissions not sent yet; an emission already sent with a time tag
+ * cannot be recalled and still starts at its time.
+ *
+ * @param[in] device_id The UART port number (e.g., "COM3") representing the device
+ * @param[in] scent_name The name of the scent to emit
+ * @param[in] duration The duration of emission
+ * @param[in] time_us The time of the emission in microseconds, on the clock of sony_odGetTime
+ * @param[out] is_available A boolean flag set to true if the emission is scheduled, false if the scent is
+ * unavailable at that time
+ * @return OdResult Returns SUCCESS if the request is handled successfully, otherwise ERROR_UNKNOWN (e.g. a
+ * time more than 24 hours ahead)
+ */
+OLFACTORY_DEVICE_API OdResult sony_odScheduleScentEmission(const char* device_id, const char* scent_name,
+                                                           float duration, int64_t time_us,
+                                                           bool& is_available);
+
 /**
  * @brief Check if scent emission is available for the specified device.
  * @param[in] device_id The UART port number (e.g., "COM3") representing the device
@@ -98,4 +246,225 @@ OLFACTORY_DEVICE_API OdResult sony_odStopScentEmission(const char* device_id);
  */
 OLFACTORY_DEVICE_API OdResult sony_odIsScentEmissionAvailable(const char* device_id, bool& is_available);
 
+/**
+ * @brief Wait until scent emission becomes available for the specified device.
+ * @param[in] device_id The UART port number (e.g., "COM3") representing the device
+ * @param[in] timeout_ms The maximum time to wait in milliseconds, or a negative value to wait without limit
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false on timeout
+ * @return OdResult Returns SUCCESS if the wait completes or times out, otherwise ERROR_UNKNOWN (e.g. the
+ * session ended while waiting)
+ */
+OLFACTORY_DEVICE_API OdResult sony_odWaitScentEmissionAvailable(const char* device_id, int32_t timeout_ms,
+                                                                bool& is_available);
+
+/**
+ * @brief Register a callback called when scent emission becomes available again after a cooldown
+ *
+ * The callback is not called for an emission with neither a duration nor a cooldown, since the scent
+ * never becomes unavailable.
+ *
+ * @param[in] callback The callback function, or nullptr to unregister. It is called on an internal thread.
+ * @param[in] user_data A pointer passed to the callback as is
+ * @return OdResult Returns SUCCESS if the callback is registered successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odRegisterAvailabilityCallback(OdAvailabilityCallback callback,
+                                                                  void* user_data);
+
+/**
+ * @brief Register a callback called when a scent emission ends after its duration
+ *
+ * The callback is not called for emissions stopped by sony_odStopScentEmission or by the end of the
+ * session. It is called about 1 ms after the end of the emission at most.
+ *
+ * @param[in] callback The callback function, or nullptr to unregister. It is called on an internal thread.
+ * @param[in] user_data A pointer passed to the callback as is
+ * @return OdResult Returns SUCCESS if the callback is registered successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odRegisterEmissionEndCallback(OdEmissionEndCallback callback,
+                                                                 void* user_data);
+
+/**
+ * @brief Get the remaining emission and cooldown time of each scent of the specified device.
+ * @param[in] device_id The UART port number (e.g., "COM3") representing the device
+ * @param[out] times The array filled with the times of the scents, may be nullptr if capacity is 0
+ * @param[in] capacity The number of elements of times
+ * @param[out] count The number of scents of the device. Only the first capacity scents are written.
+ * @return OdResult Returns SUCCESS if the times are read successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odGetScentEmissionTimes(const char* device_id, OdScentTime* times,
+                                                           int32_t capacity, int32_t& count);
+
+/**
+ * @brief Get the handle of the specified device
+ *
+ * The handle can be passed to the *ByHandle functions, which reach the device directly without
+ * resolving the device id again. A handle stays valid until the library is unloaded.
+ *
+ * @param[in] device_id The device id written in device.json
+ * @param[out] handle The handle of the device
+ * @return OdResult Returns SUCCESS if the device is found, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odGetDeviceHandle(const char* device_id, int32_t& handle);
+
+/**
+ * @brief Start a session for the device of the specified handle
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @return OdResult Returns SUCCESS if the session starts successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odStartSessionByHandle(int32_t handle);
+
+/**
+ * @brief End the session for the device of the specified handle
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @return OdResult Returns SUCCESS if the session ends successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odEndSessionByHandle(int32_t handle);
+
+/**
+ * @brief Start scent emission for the device of the specified handle
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @param[in] scent The number of the scent to emit
+ * @param[in] duration The duration of emission
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false otherwise. It is
+ * false after an emission is sent, since the scent is unavailable until its cooldown ends
+ * @return OdResult Returns SUCCESS if the scent emission starts successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odStartScentEmissionByHandle(int32_t handle, int32_t scent, float duration,
+                                                                bool& is_available);
+
+/**
+ * @brief Schedule a scent emission for the device of the specified handle at a future time
+ *
+ * See sony_odScheduleScentEmission.
+ *
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @param[in] scent The number of the scent to emit
+ * @param[in] duration The duration of emission
+ * @param[in] time_us The time of the emission in microseconds, on the clock of sony_odGetTime
+ * @param[out] is_available A boolean flag set to true if the emission is scheduled, false if the scent is
+ * unavailable at that time
+ * @return OdResult Returns SUCCESS if the request is handled successfully, otherwise ERROR_UNKNOWN (e.g. a
+ * time more than 24 hours ahead)
+ */
+OLFACTORY_DEVICE_API OdResult sony_odScheduleScentEmissionByHandle(int32_t handle, int32_t scent,
+                                                                   float duration, int64_t time_us,
+                                                                   bool& is_available);
+
+/**
+ * @brief Stop scent emission for the device of the specified handle
+ *
+ * See sony_odStopScentEmission.
+ *
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @return OdResult Returns SUCCESS if the scent emission stops successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odStopScentEmissionByHandle(int32_t handle);
+
+/**
+ * @brief Check if scent emission is available for the device of the specified handle
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false otherwise
+ * @return OdResult Returns SUCCESS if the availability check is performed successfully, otherwise
+ * ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odIsScentEmissionAvailableByHandle(int32_t handle, bool& is_available);
+
+/**
+ * @brief Wait until scent emission becomes available for the device of the specified handle
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @param[in] timeout_ms The maximum time to wait in milliseconds, or a negative value to wait without limit
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false on timeout
+ * @return OdResult Returns SUCCESS if the wait completes or times out, otherwise ERROR_UNKNOWN (e.g. the
+ * session ended while waiting)
+ */
+OLFACTORY_DEVICE_API OdResult sony_odWaitScentEmissionAvailableByHandle(int32_t handle, int32_t timeout_ms,
+                                                                        bool& is_available);
+
+/**
+ * @brief Get the remaining emission and cooldown time of each scent of the device of the specified handle
+ * @param[in] handle The handle returned by sony_odGetDeviceHandle
+ * @param[out] times The array filled with the times of the scents, may be nullptr if capacity is 0
+ * @param[in] capacity The number of elements of times
+ * @param[out] count The number of scents of the device. Only the first capacity scents are written.
+ * @return OdResult Returns SUCCESS if the times are read successfully, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odGetScentEmissionTimesByHandle(int32_t handle, OdScentTime* times,
+                                                                   int32_t capacity, int32_t& count);
+
+/**
+ * @brief Write a timeline file, played by sony_odOpenTimeline
+ *
+ * The events are stored sorted by time, events at the same time keep their order. The file holds a time
+ * index so that a position is found without reading the events before it.
+ *
+ * @param[in] path The path of the file
+ * @param[in] events The emissions of the timeline
+ * @param[in] count The number of events
+ * @return OdResult Returns SUCCESS if the file is written, otherwise ERROR_UNKNOWN (e.g. a negative time)
+ */
+OLFACTORY_DEVICE_API OdResult sony_odWriteTimeline(const char* path, const OdTimelineEvent* events,
+                                                   int32_t count);
+
+/**
+ * @brief Open a timeline file written by sony_odWriteTimeline
+ *
+ * The file is mapped in memory rather than loaded, so that long timelines open at once and only the part
+ * being played is resident. The timeline is paused at its start. While it plays, each event is scheduled
+ * with sony_odScheduleScentEmissionByHandle shortly before its time, so the devices must have a session.
+ * The events of devices which are not in device.json are skipped.
+ *
+ * @param[in] path The path of the file
+ * @param[out] timeline The id of the opened timeline
+ * @return OdResult Returns SUCCESS if the timeline is opened, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odOpenTimeline(const char* path, int32_t& timeline);
+
+/**
+ * @brief Play a timeline from its position, from its start if it reached its end
+ *
+ * The playback stops by itself after the last event.
+ *
+ * @param[in] timeline The id returned by sony_odOpenTimeline
+ * @return OdResult Returns SUCCESS if the timeline is playing, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odPlayTimeline(int32_t timeline);
+
+/**
+ * @brief Pause a timeline at its position
+ *
+ * The events due within 50 ms are already scheduled and still start.
+ *
+ * @param[in] timeline The id returned by sony_odOpenTimeline
+ * @return OdResult Returns SUCCESS if the timeline is paused, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odPauseTimeline(int32_t timeline);
+
+/**
+ * @brief Move the position of a timeline, playing or paused
+ *
+ * The events due within 50 ms of the previous position are already scheduled and still start.
+ *
+ * @param[in] timeline The id returned by sony_odOpenTimeline
+ * @param[in] position_us The new position in microseconds from the start of the timeline
+ * @return OdResult Returns SUCCESS if the position is moved, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odSeekTimeline(int32_t timeline, int64_t position_us);
+
+/**
+ * @brief Get the position of a timeline
+ * @param[in] timeline The id returned by sony_odOpenTimeline
+ * @param[out] position_us The position in microseconds from the start of the timeline
+ * @param[out] is_playing A boolean flag set to true while the timeline plays
+ * @return OdResult Returns SUCCESS if the position is read, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odGetTimelinePosition(int32_t timeline, int64_t& position_us,
+                                                         bool& is_playing);
+
+/**
+ * @brief Stop a timeline and unmap its file
+ * @param[in] timeline The id returned by sony_odOpenTimeline
+ * @return OdResult Returns SUCCESS if the timeline is closed, otherwise ERROR_UNKNOWN
+ */
+OLFACTORY_DEVICE_API OdResult sony_odCloseTimeline(int32_t timeline);
+
 }  // namespace sony::olfactory_device
@@ -46,11 +46,101 @@ enum class OdLogLevel : int32_t {
   CRITICAL = 5,  ///< Critical
   OFF = 6        ///< Off
 };
+
+/** APIs whose latency is measured, see sony_odGetStats */
+enum class OdStatsApi : int32_t {
+  START_SESSION = 0,                ///< sony_odStartSession
+  END_SESSION = 1,                  ///< sony_odEndSession
+  START_SCENT_EMISSION = 2,         ///< sony_odStartScentEmission
+  STOP_SCENT_EMISSION = 3,          ///< sony_odStopScentEmission
+  IS_SCENT_EMISSION_AVAILABLE = 4,  ///< sony_odIsScentEmissionAvailable
+  GET_SCENT_EMISSION_TIMES = 5,     ///< sony_odGetScentEmissionTimes
+  SEND_DATA = 6,                    ///< Transmission of commands to a device
+  START_SCENT_EMISSIONS = 7,        ///< sony_odStartScentEmissions
+  SCHEDULE_SCENT_EMISSION = 8,      ///< sony_odScheduleScentEmission
+  START_GROUP_SCENT_EMISSION = 9,   ///< sony_odStartGroupScentEmission
+  SCHEDULED_FIRING = 10,            ///< Delay of the scheduled commands sent by the library after their time
+  COUNT = 11                        ///< Number of measured APIs
+};
 #pragma endregion ENUM_DEFINITION
 
+#pragma region STRUCT_DEFINITION
+/** Remaining times of one scent channel */
+struct OdScentTime {
+  int32_t scent;                  ///< Number of the scent, as passed to sony_odStartScentEmission
+  int32_t emission_remaining_ms;  ///< Time until the end of the emission, 0 if not emitting
+  int32_t cooldown_remaining_ms;  ///< Time until the channel is available again, 0 if available
+};
+
+/** Latency distribution of one API */
+struct OdLatencyStats {
+  uint64_t count;    ///< Number of calls
+  uint64_t mean_ns;  ///< Mean latency in nanoseconds
+  uint64_t p50_ns;   ///< Median latency in nanoseconds
+  uint64_t p90_ns;   ///< 90th percentile latency in nanoseconds
+  uint64_t p99_ns;   ///< 99th percentile latency in nanoseconds
+  uint64_t p999_ns;  ///< 99.9th percentile latency in nanoseconds
+  uint64_t max_ns;   ///< Maximum latency in nanoseconds
+};
+
+/** Number of latency entries reserved in OdStats, so that its layout does not change with OdStatsApi */
+#define OD_STATS_API_CAPACITY (32)
+
+/**
+ * Statistics of the library, see sony_odGetStats
+ *
+ * The structure only grows at its end. The library fills the first size bytes, so a caller built against
+ * an older header receives the fields it knows.
+ */
+struct OdStats {
+  uint32_t size = sizeof(OdStats);  ///< Size of the structure known by the caller
+  uint32_t api_count;               ///< Number of latency entries filled by the library
+  OdLatencyStats latency[OD_STATS_API_CAPACITY];  ///< Latency indexed by OdStatsApi, zero beyond api_count
+  uint64_t sent_commands;        ///< Number of commands sent to the devices
+  uint64_t cooldown_rejections;  ///< Number of emissions rejected because the scent was cooling down
+  uint64_t send_failures;        ///< Number of transmissions which failed
+};
+
+/** One emission of sony_odStartScentEmissions */
+struct OdScentEmission {
+  const char* device_id;  ///< Id of the device, as written in device.json
+  int32_t scent;          ///< Number of the scent, as passed to sony_odStartScentEmission
+  float duration;         ///< Duration of the emission in seconds
+};
+/** Outcome of sony_odStartGroupScentEmission */
+struct OdGroupEmission {
+  int64_t start_us;  ///< Time at which the devices start emitting, on the clock of sony_odGetTime
+  int64_t skew_us;   ///< Measured time between the start of the first and the last device in microseconds
+  int32_t devices;   ///< Number of device addresses which were released
+  bool time_tagged;  ///< True if the devices started at a shared OSC time tag
+};
+/** One emission of sony_odWriteTimeline */
+struct OdTimelineEvent {
+  int64_t time_us;        ///< Time of the emission in microseconds from the start of the timeline
+  const char* device_id;  ///< Id of the device, as written in device.json
+  int32_t scent;          ///< Number of the scent, as passed to sony_odStartScentEmission
+  float duration;         ///< Duration of the emission in seconds
+};
+#pragma endregion STRUCT_DEFINITION
+
 /**
  * @brief Log callback function type with log level
  * @param[in] level The log level of the message
  * @param[in] message The log message
  */
-using OdLogCallback = void (*)(const char*, OdLogLevel);
\ No newline at end of file
+using OdLogCallback = void (*)(const char*, OdLogLevel);
+
+/**
+ * @brief Availability callback function type
+ * @param[in] device_id The device whose scent emission became available again
+ * @param[in] user_data The pointer passed to sony_odRegisterAvailabilityCallback
+ */
+using OdAvailabilityCallback = void (*)(const char*, void*);
+
+/**
+ * @brief Emission end callback function type
+ * @param[in] device_id The device whose emission ended
+ * @param[in] scent The number of the scent, as passed to sony_odStartScentEmission
+ * @param[in] user_data The pointer passed to sony_odRegisterEmissionEndCallback
+ */
+using OdEmissionEndCallback = void (*)(const char*, int32_t, void*);
\ No newline at end of file
@@ -0,0 +1,189 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "api_stats.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace sony::olfactory_device {
+
+// Returns the bucket of a latency in nanoseconds
+static int32_t GetBucket(uint64_t ns) {
+  if (ns < STATS_EXACT_BUCKETS) {
+    return static_cast<int32_t>(ns);
+  }
+  // Position of the highest bit, at least 4 since ns >= 16
+  int32_t exponent = 63;
+  while ((ns >> exponent) == 0) {
+    exponent--;
+  }
+  if (exponent >= STATS_MAX_EXPONENT) {
+    return STATS_BUCKETS - 1;
+  }
+  // The 3 bits below the highest one select the sub-bucket
+  int32_t sub_bucket = static_cast<int32_t>((ns >> (exponent - 3)) & (STATS_SUB_BUCKETS - 1));
+  return STATS_EXACT_BUCKETS + (exponent - 4) * STATS_SUB_BUCKETS + sub_bucket;
+}
+
+// Returns the highest latency in nanoseconds which falls in a bucket
+static uint64_t GetBucketUpperBound(int32_t bucket) {
+  if (bucket < STATS_EXACT_BUCKETS) {
+    return static_cast<uint64_t>(bucket);
+  }
+  int32_t exponent = (bucket - STATS_EXACT_BUCKETS) / STATS_SUB_BUCKETS + 4;
+  int32_t sub_bucket = (bucket - STATS_EXACT_BUCKETS) % STATS_SUB_BUCKETS;
+  return ((static_cast<uint64_t>(STATS_SUB_BUCKETS + sub_bucket + 1)) << (exponent - 3)) - 1;
+}
+
+// Adds a value to an atomic only written by the calling thread, without a locked instruction
+static void AddRelaxed(std::atomic<uint64_t>& target, uint64_t value) {
+  target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Registers the block of the calling thread on first use and moves it to the total when the thread exits
+class ThreadBlockHolder {
+ public:
+  ThreadBlockHolder() : block_(new ApiStats::ThreadBlock()) {
+    for (auto& buckets : block_->buckets) {
+      for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+    for (auto& sum : block_->sum_ns) {
+      sum.store(0, std::memory_order_relaxed);
+    }
+    for (auto& counter : block_->counters) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+    ApiStats::GetInstance().Register(block_.get());
+  }
+
+  ~ThreadBlockHolder() { ApiStats::GetInstance().Unregister(block_.get()); }
+
+  ApiStats::ThreadBlock& Get() { return *block_; }
+
+ private:
+  std::unique_ptr<ApiStats::ThreadBlock> block_;
+};
+
+ApiStats::ApiStats() : retired_(new Totals()), baseline_(new Totals()) {
+  std::memset(retired_.get(), 0, sizeof(Totals));
+  std::memset(baseline_.get(), 0, sizeof(Totals));
+}
+
+ApiStats& ApiStats::GetInstance() {
+  static ApiStats instance;
+  return instance;
+}
+
+ApiStats::ThreadBlock& ApiStats::GetThreadBlock() {
+  thread_local ThreadBlockHolder holder;
+  return holder.Get();
+}
+
+void ApiStats::Record(OdStatsApi api, std::chrono::steady_clock::duration latency) {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+  uint64_t value = static_cast<uint64_t>(std::max<decltype(ns)>(ns, 0));
+  ThreadBlock& block = GetThreadBlock();
+  int32_t index = static_cast<int32_t>(api);
+  AddRelaxed(block.buckets[index][GetBucket(value)], 1);
+  AddRelaxed(block.sum_ns[index], value);
+}
+
+void ApiStats::Count(StatsCounter counter, uint64_t value) {
+  AddRelaxed(GetThreadBlock().counters[static_cast<int32_t>(counter)], value);
+}
+
+void ApiStats::Register(ThreadBlock* block) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  blocks_.push_back(block);
+}
+
+void ApiStats::Unregister(ThreadBlock* block) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AddBlock(*retired_, *block);
+  blocks_.erase(std::remove(blocks_.begin(), blocks_.end(), block), blocks_.end());
+}
+
+void ApiStats::AddBlock(Totals& totals, const ThreadBlock& block) {
+  for (int32_t api = 0; api < STATS_API_COUNT; api++) {
+    for (int32_t bucket = 0; bucket < STATS_BUCKETS; bucket++) {
+      totals.buckets[api][bucket] += block.buckets[api][bucket].load(std::memory_order_relaxed);
+    }
+    totals.sum_ns[api] += block.sum_ns[api].load(std::memory_order_relaxed);
+  }
+  for (int32_t counter = 0; counter < STATS_COUNTER_COUNT; counter++) {
+    totals.counters[counter] += block.counters[counter].load(std::memory_order_relaxed);
+  }
+}
+
+void ApiStats::Snapshot(OdStats& stats, bool reset) {
+  std::unique_ptr<Totals> totals(new Totals());
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::memcpy(totals.get(), retired_.get(), sizeof(Totals));
+  for (const ThreadBlock* block : blocks_) {
+    AddBlock(*totals, *block);
+  }
+
+  stats = OdStats();
+  stats.api_count = STATS_API_COUNT;
+  for (int32_t api = 0; api < STATS_API_COUNT; api++) {
+    OdLatencyStats& latency = stats.latency[api];
+    uint64_t buckets[STATS_BUCKETS];
+    for (int32_t bucket = 0; bucket < STATS_BUCKETS; bucket++) {
+      buckets[bucket] = totals->buckets[api][bucket] - baseline_->buckets[api][bucket];
+      latency.count += buckets[bucket];
+    }
+    if (latency.count == 0) {
+      continue;
+    }
+    latency.mean_ns = (totals->sum_ns[api] - baseline_->sum_ns[api]) / latency.count;
+
+    // Walk the buckets once for all the percentiles, each reported as the upper bound of its bucket
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    uint64_t* results[] = {&latency.p50_ns, &latency.p90_ns, &latency.p99_ns, &latency.p999_ns};
+    size_t next = 0;
+    uint64_t cumulative = 0;
+    for (int32_t bucket = 0; bucket < STATS_BUCKETS; bucket++) {
+      if (buckets[bucket] == 0) {
+        continue;
+      }
+      cumulative += buckets[bucket];
+      while (next < std::size(quantiles) && cumulative >= quantiles[next] * latency.count) {
+        *results[next++] = GetBucketUpperBound(bucket);
+      }
+      latency.max_ns = GetBucketUpperBound(bucket);
+    }
+  }
+  stats.sent_commands = totals->counters[static_cast<int32_t>(StatsCounter::SENT_COMMANDS)] -
+                        baseline_->counters[static_cast<int32_t>(StatsCounter::SENT_COMMANDS)];
+  stats.cooldown_rejections = totals->counters[static_cast<int32_t>(StatsCounter::COOLDOWN_REJECTIONS)] -
+                              baseline_->counters[static_cast<int32_t>(StatsCounter::COOLDOWN_REJECTIONS)];
+  stats.send_failures = totals->counters[static_cast<int32_t>(StatsCounter::SEND_FAILURES)] -
+                        baseline_->counters[static_cast<int32_t>(StatsCounter::SEND_FAILURES)];
+
+  if (reset) {
+    baseline_.swap(totals);
+  }
+}
+
+}  // namespace sony::olfactory_device
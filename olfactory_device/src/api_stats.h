@@ -0,0 +1,141 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "olfactory_device_defs.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+#define STATS_API_COUNT (static_cast<int32_t>(OdStatsApi::COUNT))
+static_assert(STATS_API_COUNT <= OD_STATS_API_CAPACITY, "OdStats must hold every OdStatsApi");
+#define STATS_EXACT_BUCKETS (16)  // Latencies below this value in nanoseconds have their own bucket
+#define STATS_SUB_BUCKETS (8)     // Buckets per power of 2 above STATS_EXACT_BUCKETS, 12.5% precision
+#define STATS_MAX_EXPONENT (40)   // Latencies of 2^40 ns (about 18 minutes) and more share the last bucket
+#define STATS_BUCKETS (STATS_EXACT_BUCKETS + (STATS_MAX_EXPONENT - 4) * STATS_SUB_BUCKETS + 1)
+
+namespace sony::olfactory_device {
+
+/** Counters of ApiStats */
+enum class StatsCounter : int32_t {
+  SENT_COMMANDS = 0,        // Commands sent to the devices
+  COOLDOWN_REJECTIONS = 1,  // Emissions rejected because the scent was cooling down
+  SEND_FAILURES = 2,        // Transmissions which failed
+  COUNT = 3
+};
+
+#define STATS_COUNTER_COUNT (static_cast<int32_t>(StatsCounter::COUNT))
+
+/**
+ * @brief ApiStats collects the latency of the API calls and the counters of the library.
+ *
+ * Every thread records into its own block of log-linear histograms, so recording is a few relaxed
+ * atomic operations on memory no other thread writes. Snapshot() sums the blocks of all the threads;
+ * the block of a thread which exits is added to a common total. Reset does not clear the blocks but
+ * remembers the current totals, which are subtracted from the next snapshots.
+ */
+class ApiStats {
+ public:
+  // Statistics of one thread, only written by that thread
+  struct ThreadBlock {
+    std::atomic<uint64_t> buckets[STATS_API_COUNT][STATS_BUCKETS];
+    std::atomic<uint64_t> sum_ns[STATS_API_COUNT];
+    std::atomic<uint64_t> counters[STATS_COUNTER_COUNT];
+  };
+
+ private:
+  // Plain copy of the statistics, used for the totals
+  struct Totals {
+    uint64_t buckets[STATS_API_COUNT][STATS_BUCKETS];
+    uint64_t sum_ns[STATS_API_COUNT];
+    uint64_t counters[STATS_COUNTER_COUNT];
+  };
+
+  std::mutex mutex_;                  // Protects the members below
+  std::vector<ThreadBlock*> blocks_;  // Blocks of the running threads
+  std::unique_ptr<Totals> retired_;   // Sum of the blocks of the exited threads
+  std::unique_ptr<Totals> baseline_;  // Totals at the last reset
+
+  ApiStats();
+
+  static void AddBlock(Totals& totals, const ThreadBlock& block);
+  static ThreadBlock& GetThreadBlock();
+
+ public:
+  /**
+   * @brief Returns the process-wide statistics.
+   */
+  static ApiStats& GetInstance();
+
+  /**
+   * @brief Records the latency of a call on the calling thread.
+   *
+   * @param api The measured API.
+   * @param latency The duration of the call.
+   */
+  static void Record(OdStatsApi api, std::chrono::steady_clock::duration latency);
+
+  /**
+   * @brief Adds to a counter on the calling thread.
+   *
+   * @param counter The counter to increase.
+   * @param value The value to add.
+   */
+  static void Count(StatsCounter counter, uint64_t value = 1);
+
+  /**
+   * @brief Adds a block to the snapshots. Called when a thread starts recording.
+   */
+  void Register(ThreadBlock* block);
+
+  /**
+   * @brief Moves the statistics of a block to the common total. Called when a thread exits.
+   */
+  void Unregister(ThreadBlock* block);
+
+  /**
+   * @brief Computes the statistics since the last reset.
+   *
+   * @param stats The statistics to fill.
+   * @param reset True to start the next statistics from now.
+   */
+  void Snapshot(OdStats& stats, bool reset);
+};
+
+/**
+ * @brief ScopedLatency records the time from its construction to its destruction.
+ */
+class ScopedLatency {
+ private:
+  OdStatsApi api_;
+  std::chrono::steady_clock::time_point start_;
+
+ public:
+  explicit ScopedLatency(OdStatsApi api) : api_(api), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedLatency() { ApiStats::Record(api_, std::chrono::steady_clock::now() - start_); }
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+};
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,265 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "async_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+// Third Party Libraries
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/base_sink.h>
+
+namespace sony::olfactory_device {
+
+#define ASYNC_LOG_PATTERN ("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v%n")
+#define ASYNC_LOG_IDLE_WAIT_MS (100)  // Maximum sleep of the background thread while the ring is empty
+#define CONSOLE_DEFAULT_COLOR (FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE)
+
+// Sets the color of the next console output
+static void SetConsoleColor(ConsoleColor color) {
+#ifdef _WIN32
+  SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+#else
+  // Same colors as the Windows console, only on a terminal so that redirected output stays plain
+  static const bool is_terminal = isatty(STDOUT_FILENO) != 0;
+  if (!is_terminal) {
+    return;
+  }
+  if (color == CONSOLE_DEFAULT_COLOR) {
+    std::cout << "\033[0m";
+    return;
+  }
+  int ansi = ((color & FOREGROUND_RED) ? 1 : 0) | ((color & FOREGROUND_GREEN) ? 2 : 0) |
+             ((color & FOREGROUND_BLUE) ? 4 : 0);
+  std::cout << ((color & FOREGROUND_INTENSITY) ? "\033[1;" : "\033[") << 30 + ansi << 'm';
+#endif
+}
+
+// spdlog sink which hands the messages to the ring buffer without formatting them
+class AsyncLogSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
+ protected:
+  void sink_it_(const spdlog::details::log_msg& msg) override { AsyncLog::GetInstance().PushLog(msg); }
+  void flush_() override {}
+};
+
+AsyncLog::AsyncLog()
+    : ring_(new Entry[ASYNC_LOG_QUEUE_SIZE]),
+      head_(0),
+      tail_(0),
+      dropped_(0),
+      sleeping_(false),
+      running_(false),
+      console_(true),
+      stop_(false),
+      callback_(nullptr) {
+  static_assert((ASYNC_LOG_QUEUE_SIZE & (ASYNC_LOG_QUEUE_SIZE - 1)) == 0, "must be a power of 2");
+  for (size_t i = 0; i < ASYNC_LOG_QUEUE_SIZE; i++) {
+    ring_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+AsyncLog::~AsyncLog() {
+  // spdlog may already be destroyed, only stop the background thread
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+    stop_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+AsyncLog& AsyncLog::GetInstance() {
+  static AsyncLog instance;
+  return instance;
+}
+
+void AsyncLog::Start(OdLogCallback callback, OdLogLevel level) {
+  Stop();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  callback_ = callback;
+  stop_ = false;
+  thread_ = std::thread(&AsyncLog::Run, this);
+
+  // Messages below the level are discarded by spdlog before being formatted
+  logger_ = std::make_shared<spdlog::logger>("olfactory_device", std::make_shared<AsyncLogSink>());
+  logger_->set_level(static_cast<spdlog::level::level_enum>(static_cast<int32_t>(level)));
+  previous_ = spdlog::default_logger();
+  spdlog::set_default_logger(logger_);
+  console_ = level <= OdLogLevel::INFO;
+  running_ = true;
+}
+
+void AsyncLog::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!thread_.joinable()) {
+      return;
+    }
+    running_ = false;
+    console_ = true;
+    if (previous_) {
+      spdlog::set_default_logger(previous_);
+    }
+    previous_.reset();
+    logger_.reset();
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+bool AsyncLog::Push(EntryType type, int32_t level, spdlog::log_clock::time_point time, size_t thread_id,
+                    const char* message, size_t length) {
+  // Claim an entry, the producers compete on head_ only
+  size_t position = head_.load(std::memory_order_relaxed);
+  Entry* entry = nullptr;
+  for (;;) {
+    entry = &ring_[position & (ASYNC_LOG_QUEUE_SIZE - 1)];
+    size_t sequence = entry->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The ring is full, drop the message rather than waiting for the background thread
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  entry->type = type;
+  entry->level = level;
+  entry->time = time;
+  entry->thread_id = thread_id;
+  entry->length = static_cast<uint16_t>(std::min<size_t>(length, ASYNC_LOG_MESSAGE_MAX));
+  std::memcpy(entry->message, message, entry->length);
+  // Publish the entry before reading sleeping_, see Run()
+  entry->sequence.store(position + 1);
+
+  // Wake the background thread only if it is waiting
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_one();
+  }
+  return true;
+}
+
+bool AsyncLog::PushLog(const spdlog::details::log_msg& msg) {
+  return Push(EntryType::LOG, static_cast<int32_t>(msg.level), msg.time, msg.thread_id, msg.payload.data(),
+              msg.payload.size());
+}
+
+bool AsyncLog::PushConsole(ConsoleColor color, const char* message, size_t length) {
+  return Push(EntryType::CONSOLE, color, spdlog::log_clock::now(), 0, message, length);
+}
+
+bool AsyncLog::Drain(spdlog::formatter& formatter) {
+  bool drained = false;
+  for (;;) {
+    Entry& entry = ring_[tail_ & (ASYNC_LOG_QUEUE_SIZE - 1)];
+    if (entry.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+      break;
+    }
+
+    spdlog::string_view_t message(entry.message, entry.length);
+    if (entry.type == EntryType::LOG) {
+      if (callback_) {
+        spdlog::details::log_msg msg(entry.time, spdlog::source_loc{}, "olfactory_device",
+                                     static_cast<spdlog::level::level_enum>(entry.level), message);
+        msg.thread_id = entry.thread_id;
+        spdlog::memory_buf_t buffer;
+        formatter.format(msg, buffer);
+        buffer.push_back('\0');
+        callback_(buffer.data(), static_cast<OdLogLevel>(entry.level));
+      }
+    } else {
+      SetConsoleColor(static_cast<ConsoleColor>(entry.level));
+      std::cout.write(message.data(), message.size()) << std::endl;
+      SetConsoleColor(CONSOLE_DEFAULT_COLOR);
+    }
+
+    // Hand the entry back to the producers
+    entry.sequence.store(tail_ + ASYNC_LOG_QUEUE_SIZE, std::memory_order_release);
+    tail_++;
+    drained = true;
+  }
+  return drained;
+}
+
+void AsyncLog::Run() {
+  spdlog::pattern_formatter formatter(ASYNC_LOG_PATTERN, spdlog::pattern_time_type::local, "");
+  uint64_t reported = 0;
+
+  for (;;) {
+    Drain(formatter);
+
+    // Report the messages dropped since the last report
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported && callback_) {
+      std::string message =
+          "[AsyncLog] " + std::to_string(dropped - reported) + " log messages were dropped.\n";
+      callback_(message.c_str(), OdLogLevel::WARN);
+    }
+    reported = dropped;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stop_) {
+      break;
+    }
+    // Announce the wait before checking the ring again, so that either the producer sees sleeping_ or
+    // its message is seen here
+    sleeping_.store(true);
+    Entry& entry = ring_[tail_ & (ASYNC_LOG_QUEUE_SIZE - 1)];
+    if (entry.sequence.load() != tail_ + 1) {
+      cv_.wait_for(lock, std::chrono::milliseconds(ASYNC_LOG_IDLE_WAIT_MS));
+    }
+    sleeping_.store(false);
+  }
+
+  // Deliver what was written before Stop()
+  Drain(formatter);
+}
+
+void ConsoleWrite(ConsoleColor color, const char* message, size_t length) {
+  AsyncLog& log = AsyncLog::GetInstance();
+  if (log.IsRunning()) {
+    // A dropped message is counted by AsyncLog, the console is not worth blocking the caller
+    log.PushConsole(color, message, length);
+    return;
+  }
+
+  SetConsoleColor(color);
+  std::cout.write(message, length) << std::endl;
+  SetConsoleColor(CONSOLE_DEFAULT_COLOR);
+}
+
+}  // namespace sony::olfactory_device
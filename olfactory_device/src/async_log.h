@@ -0,0 +1,185 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "olfactory_device_defs.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+#ifdef _WIN32
+#include <windows.h>
+#else
+// Console color attributes of the Windows console API, written as ANSI escape sequences elsewhere
+#define FOREGROUND_BLUE (0x0001)
+#define FOREGROUND_GREEN (0x0002)
+#define FOREGROUND_RED (0x0004)
+#define FOREGROUND_INTENSITY (0x0008)
+#endif
+
+// Third Party Libraries
+#include <spdlog/spdlog.h>
+
+#define ASYNC_LOG_QUEUE_SIZE (4096)   // Number of entries of the ring buffer, must be a power of 2
+#define ASYNC_LOG_MESSAGE_MAX (256)   // Maximum length of a message, longer messages are truncated
+
+namespace sony::olfactory_device {
+
+/** Console color attribute, a combination of the FOREGROUND_* flags */
+using ConsoleColor = uint16_t;
+
+/**
+ * @brief AsyncLog moves the formatting and the output of the log messages to a background thread.
+ *
+ * Messages are copied into a fixed-size lock-free ring buffer, which the callers only touch with a few
+ * atomic operations. The background thread formats the spdlog messages, calls the user callback and
+ * writes the console messages. When the ring buffer is full the new message is dropped, so a caller
+ * never waits for the output; the number of dropped messages is reported by the background thread.
+ * Console messages have the INFO level: they are discarded before being formatted when the level of the
+ * asynchronous log is above INFO.
+ */
+class AsyncLog {
+ private:
+  enum class EntryType : int32_t {
+    LOG = 0,      // spdlog message, delivered to the user callback
+    CONSOLE = 1,  // Console message, written to std::cout
+  };
+
+  struct Entry {
+    std::atomic<size_t> sequence;               // Position of the entry in the ring, see Push() and Pop()
+    EntryType type;                             // Destination of the message
+    int32_t level;                              // spdlog level, or console color attribute
+    spdlog::log_clock::time_point time;         // Time of the message
+    size_t thread_id;                           // Thread which wrote the message
+    uint16_t length;                            // Length of message
+    char message[ASYNC_LOG_MESSAGE_MAX];        // Message, not null-terminated
+  };
+
+  std::unique_ptr<Entry[]> ring_;               // Ring buffer of ASYNC_LOG_QUEUE_SIZE entries
+  std::atomic<size_t> head_;                    // Next position to write, shared by the producers
+  size_t tail_;                                 // Next position to read, only used by the thread
+  std::atomic<uint64_t> dropped_;               // Number of messages dropped because the ring was full
+
+  std::mutex mutex_;                            // Protects the members below
+  std::condition_variable cv_;                  // Wakes the background thread
+  std::atomic<bool> sleeping_;                  // The background thread waits on cv_
+  std::atomic<bool> running_;                   // Asynchronous logging is enabled
+  std::atomic<bool> console_;                   // Console messages are written
+  bool stop_;                                   // The background thread must exit
+  std::thread thread_;                          // Background thread
+  OdLogCallback callback_;                      // User callback for the spdlog messages
+  std::shared_ptr<spdlog::logger> logger_;      // Logger writing to the ring buffer
+  std::shared_ptr<spdlog::logger> previous_;    // Default logger before Start()
+
+  AsyncLog();
+  ~AsyncLog();
+
+  bool Push(EntryType type, int32_t level, spdlog::log_clock::time_point time, size_t thread_id,
+            const char* message, size_t length);
+  void Run();
+  bool Drain(spdlog::formatter& formatter);
+
+ public:
+  /**
+   * @brief Returns the process-wide asynchronous log.
+   */
+  static AsyncLog& GetInstance();
+
+  /**
+   * @brief Starts the background thread and routes the spdlog messages to the ring buffer.
+   *
+   * @param callback The user callback called with the formatted messages.
+   * @param level The lowest level to log. Lower messages are discarded before being formatted.
+   */
+  void Start(OdLogCallback callback, OdLogLevel level);
+
+  /**
+   * @brief Delivers the remaining messages, stops the background thread and restores the default logger.
+   */
+  void Stop();
+
+  /**
+   * @brief Checks if asynchronous logging is enabled.
+   */
+  bool IsRunning() const { return running_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Checks if console messages are written, so that callers can skip formatting them.
+   */
+  bool IsConsoleEnabled() const { return console_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Adds a spdlog message to the ring buffer. Called by the spdlog sink.
+   *
+   * @return Returns false if the message was dropped.
+   */
+  bool PushLog(const spdlog::details::log_msg& msg);
+
+  /**
+   * @brief Adds a console message to the ring buffer.
+   *
+   * @param color The console color attribute of the message.
+   * @param message The message, written with a new line.
+   * @param length The length of message.
+   * @return Returns false if the message was dropped.
+   */
+  bool PushConsole(ConsoleColor color, const char* message, size_t length);
+};
+
+/**
+ * @brief Writes a formatted message to the console in the given color.
+ *
+ * The message is written by the background thread when asynchronous logging is enabled, or directly
+ * otherwise.
+ *
+ * @param color The console color attribute of the message.
+ * @param message The message, written with a new line.
+ * @param length The length of message.
+ */
+void ConsoleWrite(ConsoleColor color, const char* message, size_t length);
+
+/**
+ * @brief Writes a message to the console in the given color, formatted like the spdlog messages.
+ *
+ * Nothing is formatted when the console messages are discarded. The message is formatted into a stack
+ * buffer, so that the caller does not allocate for it.
+ *
+ * @param color The console color attribute of the message.
+ * @param format The fmt format string of the message, written with a new line.
+ * @param args The arguments of format.
+ */
+template <typename... Args>
+void ConsoleLog(ConsoleColor color, spdlog::format_string_t<Args...> format, Args&&... args) {
+  if (!AsyncLog::GetInstance().IsConsoleEnabled()) {
+    return;
+  }
+  spdlog::memory_buf_t buffer;
+  fmt::format_to(std::back_inserter(buffer), format, std::forward<Args>(args)...);
+  ConsoleWrite(color, buffer.data(), buffer.size());
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,115 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "availability_notifier.h"
+
+namespace sony::olfactory_device {
+
+AvailabilityNotifier::AvailabilityNotifier()
+    : wakeup_(std::chrono::steady_clock::time_point::max()),
+      running_(false),
+      stop_(false),
+      handler_(nullptr) {}
+
+AvailabilityNotifier::~AvailabilityNotifier() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+AvailabilityNotifier& AvailabilityNotifier::GetInstance() {
+  static AvailabilityNotifier instance;
+  return instance;
+}
+
+void AvailabilityNotifier::SetHandler(Handler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  handler_ = handler;
+}
+
+AvailabilityNotifier::TimerId AvailabilityNotifier::Schedule(int32_t handle, int32_t channel,
+                                                             AvailabilityEvent event,
+                                                             std::chrono::steady_clock::time_point time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TimerId id = wheel_.Add(time, {handle, channel, event}, std::chrono::steady_clock::now());
+
+  if (!running_) {
+    // The previous timer thread has exited, or was never started
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    running_ = true;
+    thread_ = std::thread(&AvailabilityNotifier::Run, this);
+  } else if (time < wakeup_) {
+    // The new event comes before the wake up of the timer thread, wake it to shorten its sleep
+    cv_.notify_one();
+  }
+  return id;
+}
+
+bool AvailabilityNotifier::Cancel(TimerId id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return wheel_.Cancel(id);
+}
+
+size_t AvailabilityNotifier::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return wheel_.Size();
+}
+
+void AvailabilityNotifier::Run() {
+  std::vector<Expired> expired;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_ && wheel_.Size() > 0) {
+    wakeup_ = wheel_.NextWakeup();
+    if (std::chrono::steady_clock::now() < wakeup_) {
+      cv_.wait_until(lock, wakeup_);
+      continue;
+    }
+    // The thread is awake, new events need no notification until it sleeps again
+    wakeup_ = std::chrono::steady_clock::time_point::min();
+
+    wheel_.Advance(std::chrono::steady_clock::now(),
+                   [&expired](TimerId id, const Event& event) { expired.push_back({id, event}); });
+    if (expired.empty()) {
+      continue;
+    }
+    Handler handler = handler_;
+
+    // Call the handler without the lock, it may schedule new events
+    lock.unlock();
+    if (handler) {
+      for (const Expired& entry : expired) {
+        handler(entry.event.handle, entry.event.channel, entry.event.event, entry.id);
+      }
+    }
+    expired.clear();
+    lock.lock();
+  }
+  wakeup_ = std::chrono::steady_clock::time_point::max();
+  running_ = false;
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,120 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "timing_wheel.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace sony::olfactory_device {
+
+/** Events reported by AvailabilityNotifier */
+enum class AvailabilityEvent : int32_t {
+  EMISSION_END = 0,  // The emission of a channel ends
+  COOLDOWN_END = 1   // The cooldown of a channel ends
+};
+
+/**
+ * @brief AvailabilityNotifier runs a single timer thread which reports the end of the emissions and
+ * of the cooldowns of all the channels.
+ *
+ * Emissions schedule their events with Schedule(). The events are kept in a TimingWheel, so adding,
+ * cancelling and expiring one is O(1) however many channels are active. The timer thread sleeps until
+ * the wheel has something to do and then calls the handler for each expired event, about one tick
+ * (TIMING_WHEEL_TICK_US) after its time at most. The thread is started by Schedule() and exits as soon
+ * as nothing is left to wait for.
+ */
+class AvailabilityNotifier {
+ public:
+  using TimerId = TimingWheel<int32_t>::TimerId;
+  using Handler = void (*)(int32_t handle, int32_t channel, AvailabilityEvent event, TimerId id);
+
+ private:
+  struct Event {
+    int32_t handle;           // Device handle of the emission
+    int32_t channel;          // Channel of the emission
+    AvailabilityEvent event;  // What ends at the time of the timer
+  };
+
+  struct Expired {
+    TimerId id;   // Timer of the event
+    Event event;  // Event to report
+  };
+
+  std::mutex mutex_;                              // Protects the members below
+  std::condition_variable cv_;                    // Wakes the timer thread
+  TimingWheel<Event> wheel_;                      // Pending events
+  std::chrono::steady_clock::time_point wakeup_;  // Time until which the timer thread sleeps
+  std::thread thread_;                            // Timer thread
+  bool running_;                                  // Timer thread is running
+  bool stop_;                                     // Timer thread must exit
+  Handler handler_;                               // Called for each event
+
+  AvailabilityNotifier();
+  ~AvailabilityNotifier();
+
+  void Run();
+
+ public:
+  /**
+   * @brief Returns the process-wide notifier.
+   */
+  static AvailabilityNotifier& GetInstance();
+
+  /**
+   * @brief Sets the function called by the timer thread when a scheduled time is reached.
+   *
+   * @param handler The function to call.
+   */
+  void SetHandler(Handler handler);
+
+  /**
+   * @brief Schedules a call of the handler for a channel of a device.
+   *
+   * @param handle The device handle to pass to the handler.
+   * @param channel The channel to pass to the handler.
+   * @param event The event to pass to the handler.
+   * @param time The time at which the handler is called.
+   * @return Returns the id of the timer, passed to the handler and to Cancel().
+   */
+  TimerId Schedule(int32_t handle, int32_t channel, AvailabilityEvent event,
+                   std::chrono::steady_clock::time_point time);
+
+  /**
+   * @brief Cancels a call of the handler scheduled with Schedule().
+   *
+   * @param id The id returned by Schedule().
+   * @return Returns true if the call was cancelled, false if the handler was already called or is being
+   * called.
+   */
+  bool Cancel(TimerId id);
+
+  /**
+   * @brief Returns the number of scheduled calls.
+   */
+  size_t Size();
+};
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,73 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+namespace sony::olfactory_device {
+
+/** Commands understood by the device */
+enum class CommandOpcode : int32_t {
+  RELEASE = 0, /**< Release a scent: target is the channel, level the duration in seconds */
+  MOTOR = 1,   /**< Drive a motor: target is the motor, level the speed */
+  RESET = 2,   /**< Reset the device */
+};
+
+/**
+ * @brief DeviceCommand is a command to a device, built by the API layer and encoded by each session.
+ */
+struct DeviceCommand {
+  CommandOpcode opcode;  // Command to execute
+  int32_t target;        // Channel or motor the command applies to
+  int32_t level;         // Argument of the command
+};
+
+/**
+ * @brief Returns the name of the command as written on the wire (e.g., "release").
+ */
+inline const char* GetCommandName(CommandOpcode opcode) {
+  switch (opcode) {
+    case CommandOpcode::RELEASE:
+      return "release";
+    case CommandOpcode::MOTOR:
+      return "motor";
+    case CommandOpcode::RESET:
+      return "reset";
+  }
+  return "unknown";
+}
+
+/**
+ * @brief Formats the command as ASCII text (e.g., "release(0, 3)") into the given buffer.
+ *
+ * The spacing is the one of the session and stop commands of the string-based implementation, such as
+ * "motor(0, 30)" and "release(0, 0)".
+ *
+ * @param command The command to format.
+ * @param buffer The buffer to write to. The text is null terminated.
+ * @param size The size of the buffer.
+ * @return Returns the length of the text, excluding the null terminator.
+ */
+inline int FormatCommand(const DeviceCommand& command, char* buffer, size_t size) {
+  return snprintf(buffer, size, "%s(%d, %d)", GetCommandName(command.opcode), command.target, command.level);
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,109 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "device_handle_table.h"
+
+#include <mutex>
+
+namespace sony::olfactory_device {
+
+DeviceHandleTable::DeviceHandleTable()
+    : entries_(std::make_unique<DeviceHandleEntry[]>(DEVICE_HANDLE_MAX)),
+      count_(0) {}
+
+// Returns true if two devices have the same settings
+static bool SameSettings(const DeviceInfo& a, const DeviceInfo& b) {
+  return a.ip == b.ip && a.channels == b.channels && a.cooldowns == b.cooldowns && a.motor == b.motor &&
+         a.timetags == b.timetags && a.protocol == b.protocol;
+}
+
+DeviceHandleTable& DeviceHandleTable::GetInstance() {
+  static DeviceHandleTable instance;
+  return instance;
+}
+
+bool DeviceHandleTable::Resolve(const std::string& id, int32_t& handle) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = handles_.find(id);
+    if (it != handles_.end()) {
+      handle = it->second;
+      return true;
+    }
+  }
+
+  // Load device.json on first use
+  DeviceRegistry& registry = DeviceRegistry::GetInstance();
+  if (!registry.LoadOnce()) {
+    return false;
+  }
+  DeviceInfo info;
+  if (!registry.Find(id, info)) {
+    return false;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto it = handles_.find(id);
+  if (it != handles_.end()) {
+    handle = it->second;
+    return true;
+  }
+
+  // Reuse the entry of an earlier load if the settings of the device did not change
+  auto range = ids_.equal_range(id);
+  for (auto old = range.first; old != range.second; ++old) {
+    if (SameSettings(entries_[old->second].info, info)) {
+      handles_.emplace(id, old->second);
+      handle = old->second;
+      return true;
+    }
+  }
+
+  int32_t count = count_.load(std::memory_order_relaxed);
+  if (count >= DEVICE_HANDLE_MAX) {
+    return false;
+  }
+
+  // Fill the entry before publishing it to Get()
+  DeviceHandleEntry& entry = entries_[count];
+  entry.id = id;
+  entry.slot = SessionTable::GetInstance().FindOrCreate(info.ip);
+  entry.info = std::move(info);
+  count_.store(count + 1, std::memory_order_release);
+
+  handles_.emplace(id, count);
+  ids_.emplace(id, count);
+  handle = count;
+  return true;
+}
+
+const DeviceHandleEntry* DeviceHandleTable::Get(int32_t handle) const {
+  if (handle < 0 || handle >= count_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return &entries_[handle];
+}
+
+void DeviceHandleTable::Reset() {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  handles_.clear();
+}
+
+}  // namespace sony::olfactory_device
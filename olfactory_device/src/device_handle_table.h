@@ -0,0 +1,97 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "device_registry.h"
+#include "session_table.h"
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#define DEVICE_HANDLE_MAX (16384)  // Maximum number of device handles
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief DeviceHandleEntry holds everything an API call needs to reach a device.
+ */
+struct DeviceHandleEntry {
+  std::string id;                    // Device id as written in device.json
+  DeviceInfo info;                   // Settings of the device
+  std::shared_ptr<DeviceSlot> slot;  // Session and timing state of the device address
+};
+
+/**
+ * @brief DeviceHandleTable maps device ids to integer handles.
+ *
+ * A handle is an index into a dense, fixed-capacity array of entries. An entry is never modified or
+ * removed once published, so Get() is a bounds check and an array access without any lock or hashing.
+ * Reloading device.json only forgets the id to handle mapping; handles already returned stay valid with
+ * the settings they were resolved with. An id resolved again with the settings of one of its entries
+ * gets the handle of that entry back, so the array only grows when the settings of a device change.
+ */
+class DeviceHandleTable {
+ private:
+  mutable std::shared_mutex mutex_;                     // Protects handles_ and the entries being added
+  std::unordered_map<std::string, int32_t> handles_;    // Handles indexed by device id
+  std::unordered_multimap<std::string, int32_t> ids_;   // All the handles ever created for each id
+  std::unique_ptr<DeviceHandleEntry[]> entries_;        // Entries indexed by handle
+  std::atomic<int32_t> count_;                          // Number of published entries
+
+  DeviceHandleTable();
+
+ public:
+  /**
+   * @brief Returns the process-wide handle table.
+   */
+  static DeviceHandleTable& GetInstance();
+
+  /**
+   * @brief Returns the handle of a device, creating it on the first call for the id.
+   *
+   * device.json is loaded on first use.
+   *
+   * @param id The device id as written in device.json.
+   * @param handle Receives the handle of the device.
+   * @return Returns true if the id is registered, false otherwise.
+   */
+  bool Resolve(const std::string& id, int32_t& handle);
+
+  /**
+   * @brief Returns the entry of a handle.
+   *
+   * @param handle A handle returned by Resolve().
+   * @return Returns the entry, or nullptr if the handle is invalid.
+   */
+  const DeviceHandleEntry* Get(int32_t handle) const;
+
+  /**
+   * @brief Forgets the id to handle mapping so that ids are resolved again from device.json.
+   *
+   * The entries are kept, so that an id whose settings did not change resolves to the same handle.
+   */
+  void Reset();
+};
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,239 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "device_registry.h"
+#include "picojson.h"
+
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace sony::olfactory_device {
+
+// Uncomment to use the registry key's path
+//#define USE_JSON_PATH_FROM_REGISTRY_KEY
+
+#ifdef _WIN32
+#define FILE_DEVICE_JSON ("C:\\Program Files\\Sony\\Olfactory\\device.json")
+#else
+#define FILE_DEVICE_JSON ("/etc/sony/olfactory/device.json")
+#endif
+
+#ifdef USE_JSON_PATH_FROM_REGISTRY_KEY
+/** Get the installation path from a registry key */
+static std::wstring GetInstallPath() {
+  HKEY hkey = HKEY_LOCAL_MACHINE;
+  const std::wstring sub_key = std::wstring(L"SOFTWARE\\Sony Corporation\\Olfactory");
+  const std::wstring value = L"Path";
+
+  DWORD data_size{};
+  LONG return_code =
+      ::RegGetValueW(hkey, sub_key.c_str(), value.c_str(), RRF_RT_REG_SZ, nullptr, nullptr, &data_size);
+  if (return_code != ERROR_SUCCESS) {
+    return L"";
+  }
+
+  std::wstring data;
+  data.resize(data_size / sizeof(wchar_t));
+
+  return_code =
+      ::RegGetValueW(hkey, sub_key.c_str(), value.c_str(), RRF_RT_REG_SZ, nullptr, &data[0], &data_size);
+  if (return_code != ERROR_SUCCESS) {
+    return L"";
+  }
+
+  DWORD string_length_in_wchars = data_size / sizeof(wchar_t);
+
+  // Exclude the NULL written by the Win32 API
+  string_length_in_wchars--;
+
+  data.resize(string_length_in_wchars);
+  return data;
+}
+#endif
+
+// Parse the channels and cooldowns of a device entry
+//
+// "channels" lists the channel of each scent. Older files give the channels of the two scents in
+// "scent0" and "scent1" instead. "cooldown" is either one value for all the scents or one value per
+// scent, and defaults to DEVICE_DEFAULT_COOLDOWN.
+static bool ParseChannels(const picojson::value& device, DeviceInfo& info) {
+  const picojson::value& channels = device.get("channels");
+  if (channels.is<picojson::array>()) {
+    for (const auto& channel : channels.get<picojson::array>()) {
+      info.channels.push_back(static_cast<int32_t>(channel.get<double>()));
+    }
+  } else {
+    info.channels.push_back(static_cast<int32_t>(device.get("scent0").get<double>()));
+    info.channels.push_back(static_cast<int32_t>(device.get("scent1").get<double>()));
+  }
+  for (int32_t channel : info.channels) {
+    if (channel < 0 || channel >= DEVICE_CHANNEL_MAX) {
+      std::cerr << "JSON parse error: channel " << channel << " is out of range." << std::endl;
+      return false;
+    }
+  }
+
+  const picojson::value& cooldown = device.get("cooldown");
+  if (cooldown.is<picojson::array>()) {
+    for (const auto& value : cooldown.get<picojson::array>()) {
+      info.cooldowns.push_back(static_cast<float>(value.get<double>()));
+    }
+    if (info.cooldowns.size() != info.channels.size()) {
+      std::cerr << "JSON parse error: \"cooldown\" does not match the number of channels." << std::endl;
+      return false;
+    }
+  } else if (cooldown.is<double>()) {
+    info.cooldowns.assign(info.channels.size(), static_cast<float>(cooldown.get<double>()));
+  } else {
+    info.cooldowns.assign(info.channels.size(), DEVICE_DEFAULT_COOLDOWN);
+  }
+  return true;
+}
+
+// Parse the contents of device.json into a map indexed by device id
+static bool ParseJson(std::ifstream& input_file, std::unordered_map<std::string, DeviceInfo>& devices) {
+  if (!input_file) {
+    std::cerr << "Failed to open device.json." << std::endl;
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << input_file.rdbuf();
+  std::string json = buffer.str();
+
+  // parse JSON
+  picojson::value v;
+  std::string err = picojson::parse(v, json);
+  if (!err.empty()) {
+    std::cerr << "JSON parse error: " << err << std::endl;
+    return false;
+  }
+  if (!v.is<picojson::object>() || !v.get("device").is<picojson::array>()) {
+    std::cerr << "JSON parse error: \"device\" array not found." << std::endl;
+    return false;
+  }
+
+  // Get device info
+  const picojson::array& array = v.get("device").get<picojson::array>();
+  for (const auto& device : array) {
+    DeviceInfo info;
+    info.ip = device.get("ip").get<std::string>();
+    if (!ParseChannels(device, info)) {
+      return false;
+    }
+    info.motor = static_cast<int>(device.get("motor").get<double>());
+    // Devices execute the bundles as soon as they are received unless "timetags" is true
+    const picojson::value& timetags = device.get("timetags");
+    info.timetags = timetags.is<bool>() && timetags.get<bool>();
+    // Serial devices are driven in text unless "protocol" is "binary"
+    const picojson::value& protocol = device.get("protocol");
+    info.protocol = DEVICE_DEFAULT_PROTOCOL;
+    if (protocol.is<std::string>()) {
+      if (protocol.get<std::string>() == "binary") {
+        info.protocol = UartProtocol::BINARY;
+      } else if (protocol.get<std::string>() == "text") {
+        info.protocol = UartProtocol::TEXT;
+      } else {
+        std::cerr << "JSON parse error: unknown protocol \"" << protocol.get<std::string>() << "\"."
+                  << std::endl;
+        return false;
+      }
+    }
+    // The last entry wins when an id is duplicated
+    devices[device.get("id").get<std::string>()] = info;
+  }
+  return true;
+}
+
+DeviceRegistry::DeviceRegistry() : loaded_(false), attempted_(false) {}
+
+DeviceRegistry& DeviceRegistry::GetInstance() {
+  static DeviceRegistry instance;
+  return instance;
+}
+
+bool DeviceRegistry::Load() {
+// JSON file
+#ifdef USE_JSON_PATH_FROM_REGISTRY_KEY
+  std::wstring directry = GetInstallPath();
+  std::wstring path = directry + L"json\\device.json";
+  std::ifstream input_file(path);
+#else
+  std::ifstream input_file(FILE_DEVICE_JSON);
+#endif
+
+  std::unordered_map<std::string, DeviceInfo> devices;
+  bool parsed = ParseJson(input_file, devices);
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  attempted_ = true;
+  if (!parsed) {
+    return false;
+  }
+  devices_.swap(devices);
+  loaded_ = true;
+  return true;
+}
+
+bool DeviceRegistry::Load(const std::string& path) {
+  std::ifstream input_file(path);
+
+  std::unordered_map<std::string, DeviceInfo> devices;
+  if (!ParseJson(input_file, devices)) {
+    return false;
+  }
+
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  devices_.swap(devices);
+  loaded_ = true;
+  attempted_ = true;
+  return true;
+}
+
+bool DeviceRegistry::LoadOnce() {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (attempted_) {
+      return loaded_;
+    }
+  }
+  return Load();
+}
+
+bool DeviceRegistry::IsLoaded() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return loaded_;
+}
+
+bool DeviceRegistry::Find(const std::string& id, DeviceInfo& info) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = devices_.find(id);
+  if (it == devices_.end()) {
+    return false;
+  }
+  info = it->second;
+  return true;
+}
+
+}  // namespace sony::olfactory_device
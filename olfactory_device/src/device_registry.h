@@ -0,0 +1,112 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "uart_protocol.h"
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define DEVICE_CHANNEL_MAX (64)         // Number of channels a device can have
+#define DEVICE_DEFAULT_COOLDOWN (6.0f)  // Cooldown in seconds when device.json does not set it
+#define DEVICE_DEFAULT_PROTOCOL (UartProtocol::TEXT)  // Serial protocol when device.json does not set it
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief DeviceInfo holds the settings of one device entry in device.json.
+ */
+struct DeviceInfo {
+  std::string ip;                 // Address of the device (IP address or COM port)
+  std::vector<int32_t> channels;  // Channel used for each scent, indexed by the scent number
+  std::vector<float> cooldowns;   // Cooldown in seconds after an emission, indexed by the scent number
+  int motor;                      // Motor index
+  bool timetags;                  // The device executes OSC bundles at their time tag
+  UartProtocol protocol;          // Protocol requested from a serial device when its session starts
+};
+
+/**
+ * @brief DeviceRegistry caches the contents of device.json.
+ *
+ * device.json is read and parsed once, and the devices are indexed by id so that API calls can
+ * resolve a device without touching the filesystem. The registry can be used from several threads;
+ * lookups share a lock and are only blocked while device.json is being replaced.
+ */
+class DeviceRegistry {
+ private:
+  mutable std::shared_mutex mutex_;                      // Protects the members below
+  std::unordered_map<std::string, DeviceInfo> devices_;  // Devices indexed by id
+  bool loaded_;                                          // True once device.json has been loaded
+  bool attempted_;                                       // True once a load has been attempted
+
+  DeviceRegistry();
+
+ public:
+  /**
+   * @brief Returns the process-wide registry instance.
+   */
+  static DeviceRegistry& GetInstance();
+
+  /**
+   * @brief Loads the device.json of the installation.
+   *
+   * @return Returns true if the file was read and parsed successfully, false otherwise.
+   */
+  bool Load();
+
+  /**
+   * @brief Loads the specified device.json, replacing the current contents of the registry.
+   *
+   * @param path The path of the JSON file to load.
+   * @return Returns true if the file was read and parsed successfully, false otherwise.
+   */
+  bool Load(const std::string& path);
+
+  /**
+   * @brief Loads the device.json of the installation unless a load has already been attempted.
+   *
+   * A missing or invalid device.json is read and reported once; it is read again only by an explicit
+   * Load().
+   *
+   * @return Returns true if the registry holds a loaded device.json, false otherwise.
+   */
+  bool LoadOnce();
+
+  /**
+   * @brief Checks if device.json has already been loaded.
+   *
+   * @return Returns true if the registry holds a loaded device.json, false otherwise.
+   */
+  bool IsLoaded() const;
+
+  /**
+   * @brief Looks up a device by its id.
+   *
+   * @param id The device id as written in device.json.
+   * @param info Receives a copy of the device settings.
+   * @return Returns true if the id is registered, false otherwise.
+   */
+  bool Find(const std::string& id, DeviceInfo& info) const;
+};
+
+}  // namespace sony::olfactory_device
@@ -19,7 +19,12 @@
  */
 
 #pragma once
+#include "device_command.h"
+#include "uart_protocol.h"
+
+#include <chrono>
 #include <string>
+#include <vector>
 
 namespace sony::olfactory_device {
 
@@ -55,15 +60,65 @@ class DeviceSessionIF {
   virtual bool IsConnected() const = 0;
 
   /**
-   * @brief Sends data to the connected device.
+   * @brief Sends a command to the connected device.
    *
-   * This function sends the specified data to the device over the active connection.
-   * The device must be connected before calling this function.
+   * This function encodes the specified command in the wire format of the session and sends it to the
+   * device over the active connection. The device must be connected before calling this function.
    *
-   * @param data A reference to the string containing the data to send.
-   * @return Returns true if the data was successfully sent, false otherwise.
+   * @param command A reference to the command to send.
+   * @return Returns true if the command was successfully sent, false otherwise.
+   */
+  virtual bool SendData(const DeviceCommand& command) = 0;
+
+  /**
+   * @brief Sends several commands to the connected device at once.
+   *
+   * The default implementation sends the commands one by one with SendData(). Sessions which can carry
+   * several commands in a single transmission override this function.
+   *
+   * @param commands The commands to send, in order.
+   * @return Returns true if all the commands were successfully sent, false otherwise.
+   */
+  virtual bool SendDataBatch(const std::vector<DeviceCommand>& commands) {
+    for (const auto& command : commands) {
+      if (!SendData(command)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Checks if the session can send commands which the device executes at a given time.
+   *
+   * @return Returns true if SendDataAt() carries the execution time to the device, false otherwise.
+   */
+  virtual bool SupportsTimeTags() const { return false; }
+
+  /**
+   * @brief Sets the protocol requested from the device by the next Open().
+   *
+   * Only the serial sessions have a choice of protocol, the default implementation ignores it.
+   *
+   * @param protocol The protocol to request.
+   */
+  virtual void SetProtocol(UartProtocol /*protocol*/) {}
+
+  /**
+   * @brief Sends several commands which the device executes at the given time.
+   *
+   * The commands are sent now, early, together with their execution time, so that the transmission and
+   * host delays do not shift the moment they run. The default implementation has no way to carry the
+   * time and sends the commands immediately with SendDataBatch(), see SupportsTimeTags().
+   *
+   * @param commands The commands to send, in order.
+   * @param time The time at which the device executes the commands.
+   * @return Returns true if all the commands were successfully sent, false otherwise.
    */
-  virtual bool SendData(const std::string& data) = 0;
+  virtual bool SendDataAt(const std::vector<DeviceCommand>& commands,
+                          std::chrono::steady_clock::time_point /*time*/) {
+    return SendDataBatch(commands);
+  }
 
   /**
    * @brief Receives data from the connected device.
@@ -0,0 +1,150 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "emission_scheduler.h"
+#include "api_stats.h"
+
+#include <algorithm>
+#include <functional>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace sony::olfactory_device {
+
+EmissionScheduler::EmissionScheduler()
+    : running_(false),
+      stop_(false),
+      handler_(nullptr),
+      spin_(std::chrono::microseconds(EMISSION_SCHEDULER_SPIN_US)) {}
+
+EmissionScheduler::~EmissionScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+EmissionScheduler& EmissionScheduler::GetInstance() {
+  static EmissionScheduler instance;
+  return instance;
+}
+
+void EmissionScheduler::SetHandler(Handler handler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  handler_ = handler;
+}
+
+void EmissionScheduler::Schedule(int32_t handle, uint64_t generation, const DeviceCommand& command,
+                                 std::chrono::steady_clock::time_point time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.push_back({time, handle, generation, command});
+  std::push_heap(events_.begin(), events_.end(), std::greater<Event>());
+
+  if (!running_) {
+    // The previous scheduler thread has exited, or was never started
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    running_ = true;
+    thread_ = std::thread(&EmissionScheduler::Run, this);
+  } else if (events_.front().time == time) {
+    // The new event is the earliest one, wake the scheduler thread to shorten its sleep
+    cv_.notify_one();
+  }
+}
+
+size_t EmissionScheduler::Cancel(int32_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto end = std::remove_if(events_.begin(), events_.end(),
+                            [handle](const Event& event) { return event.handle == handle; });
+  size_t removed = events_.end() - end;
+  if (removed > 0) {
+    events_.erase(end, events_.end());
+    std::make_heap(events_.begin(), events_.end(), std::greater<Event>());
+  }
+  return removed;
+}
+
+std::chrono::steady_clock::duration EmissionScheduler::SpinTime() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return spin_;
+}
+
+void EmissionScheduler::Calibrate(std::chrono::steady_clock::duration oversleep) {
+  const std::chrono::steady_clock::duration min = std::chrono::microseconds(EMISSION_SCHEDULER_SPIN_MIN_US);
+  const std::chrono::steady_clock::duration max = std::chrono::microseconds(EMISSION_SCHEDULER_SPIN_MAX_US);
+  auto target = std::clamp(oversleep * 2, min, max);
+  // A late wake up must not happen twice, an early one only saves a little spinning
+  spin_ = target > spin_ ? target : spin_ - (spin_ - target) / 16;
+}
+
+void EmissionScheduler::Run() {
+#ifdef _WIN32
+  // The default tick of 15.6 ms would make every sleep late by up to a tick
+  timeBeginPeriod(EMISSION_SCHEDULER_TIMER_MS);
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_ && !events_.empty()) {
+    auto time = events_.front().time;
+    auto now = std::chrono::steady_clock::now();
+    if (now < time - spin_) {
+      auto wake_time = time - spin_;
+      if (cv_.wait_until(lock, wake_time) == std::cv_status::timeout) {
+        Calibrate(std::chrono::steady_clock::now() - wake_time);
+      }
+      continue;
+    }
+    if (now < time) {
+      // Spin without the lock until the time, then check the heap again as it may have changed
+      lock.unlock();
+      while (std::chrono::steady_clock::now() < time) {
+        std::this_thread::yield();
+      }
+      lock.lock();
+      continue;
+    }
+
+    std::pop_heap(events_.begin(), events_.end(), std::greater<Event>());
+    Event event = events_.back();
+    events_.pop_back();
+    Handler handler = handler_;
+
+    // Call the handler without the lock, it may schedule new events
+    lock.unlock();
+    ApiStats::Record(OdStatsApi::SCHEDULED_FIRING, std::chrono::steady_clock::now() - event.time);
+    if (handler) {
+      handler(event.handle, event.generation, event.command);
+    }
+    lock.lock();
+  }
+  running_ = false;
+#ifdef _WIN32
+  timeEndPeriod(EMISSION_SCHEDULER_TIMER_MS);
+#endif
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,116 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "device_command.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#define EMISSION_SCHEDULER_SPIN_US (2000)       // Initial spin time, the OS timers are coarser
+#define EMISSION_SCHEDULER_SPIN_MIN_US (100)    // Shortest spin time, covers the wake up of the thread
+#define EMISSION_SCHEDULER_SPIN_MAX_US (20000)  // Longest spin time, above the default 15.6 ms Windows tick
+#define EMISSION_SCHEDULER_TIMER_MS (1)         // Windows timer resolution requested while commands wait
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief EmissionScheduler sends the scheduled commands of the devices which do not honor time tags.
+ *
+ * Commands are queued with Schedule() in a min-heap ordered by their time. The scheduler thread sleeps
+ * until shortly before the earliest time and spins the rest, so that the handler is called within a few
+ * microseconds of the time instead of the granularity of the OS timers. The spin time follows how late
+ * the sleeps wake up: it grows at once to twice the latest oversleep and shrinks slowly back when the
+ * timers are more precise. The delay of each call of the handler is recorded in ApiStats as
+ * OdStatsApi::SCHEDULED_FIRING. The thread is started by Schedule() and exits as soon as nothing is left
+ * to wait for.
+ */
+class EmissionScheduler {
+ public:
+  using Handler = void (*)(int32_t handle, uint64_t generation, const DeviceCommand& command);
+
+ private:
+  struct Event {
+    std::chrono::steady_clock::time_point time;  // Time at which the command is sent
+    int32_t handle;                              // Device handle of the command
+    uint64_t generation;                         // Session generation of the device, see DeviceSlot
+    DeviceCommand command;                       // Command to send
+
+    bool operator>(const Event& other) const { return time > other.time; }
+  };
+
+  std::mutex mutex_;                          // Protects the members below
+  std::condition_variable cv_;                // Wakes the scheduler thread
+  std::vector<Event> events_;                 // Min-heap of the events, earliest first
+  std::thread thread_;                        // Scheduler thread
+  bool running_;                              // Scheduler thread is running
+  bool stop_;                                 // Scheduler thread must exit
+  Handler handler_;                           // Called for each event
+  std::chrono::steady_clock::duration spin_;  // Time spun before each event
+
+  EmissionScheduler();
+  ~EmissionScheduler();
+
+  void Run();
+  void Calibrate(std::chrono::steady_clock::duration oversleep);
+
+ public:
+  /**
+   * @brief Returns the process-wide scheduler.
+   */
+  static EmissionScheduler& GetInstance();
+
+  /**
+   * @brief Sets the function called by the scheduler thread when the time of a command is reached.
+   *
+   * @param handler The function to call.
+   */
+  void SetHandler(Handler handler);
+
+  /**
+   * @brief Schedules a command to a device.
+   *
+   * @param handle The device handle to pass to the handler.
+   * @param generation The session generation to pass to the handler.
+   * @param command The command to pass to the handler.
+   * @param time The time at which the handler is called.
+   */
+  void Schedule(int32_t handle, uint64_t generation, const DeviceCommand& command,
+                std::chrono::steady_clock::time_point time);
+
+  /**
+   * @brief Removes the commands scheduled for a device.
+   *
+   * @param handle The device handle passed to Schedule().
+   * @return Returns the number of commands removed.
+   */
+  size_t Cancel(int32_t handle);
+
+  /**
+   * @brief Returns the time currently spun before each event.
+   */
+  std::chrono::steady_clock::duration SpinTime();
+};
+
+}  // namespace sony::olfactory_device
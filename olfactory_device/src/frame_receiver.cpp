@@ -0,0 +1,148 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "frame_receiver.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace sony::olfactory_device {
+
+// Size of the length prefix of FrameMode::LENGTH_PREFIXED
+static const size_t kLengthPrefixSize = 2;
+
+FrameReceiver::FrameReceiver(FrameMode mode, size_t size)
+    : buffer_(std::max<size_t>(size, kLengthPrefixSize + 1)),
+      mode_(mode),
+      head_(0),
+      tail_(0),
+      scan_(0),
+      pending_(0),
+      discard_(0),
+      discarding_(false),
+      dropped_(0) {}
+
+void FrameReceiver::Release() {
+  head_ += pending_;
+  pending_ = 0;
+  if (head_ == tail_) {
+    head_ = tail_ = scan_ = 0;
+  }
+}
+
+char* FrameReceiver::WritePointer(size_t& size) {
+  Release();
+
+  // Move the partial frame back to the start once the end of the buffer gets close
+  if (head_ > 0 && buffer_.size() - tail_ < buffer_.size() / 4) {
+    memmove(buffer_.data(), buffer_.data() + head_, tail_ - head_);
+    tail_ -= head_;
+    scan_ = (scan_ > head_) ? scan_ - head_ : 0;
+    head_ = 0;
+  }
+
+  // The buffer is full of a single frame which can never complete
+  if (tail_ == buffer_.size()) {
+    dropped_ += tail_;
+    head_ = tail_ = scan_ = 0;
+    discarding_ = (mode_ == FrameMode::NEWLINE);
+  }
+
+  size = buffer_.size() - tail_;
+  return buffer_.data() + tail_;
+}
+
+void FrameReceiver::Commit(size_t size) {
+  tail_ += std::min(size, buffer_.size() - tail_);
+}
+
+bool FrameReceiver::Next(std::string_view& frame) {
+  Release();
+
+  if (mode_ == FrameMode::NEWLINE) {
+    while (true) {
+      const char* data = buffer_.data();
+      const char* newline = static_cast<const char*>(memchr(data + scan_, '\n', tail_ - scan_));
+      if (newline == nullptr) {
+        scan_ = tail_;
+        return false;
+      }
+      size_t end = newline - data;
+      size_t length = end - head_;
+      scan_ = end + 1;
+      if (discarding_) {
+        // Rest of a dropped frame
+        dropped_ += length + 1;
+        head_ = scan_;
+        discarding_ = false;
+        continue;
+      }
+      if (length > 0 && data[end - 1] == '\r') {
+        length--;
+      }
+      if (length == 0) {
+        head_ = scan_;
+        continue;
+      }
+      frame = std::string_view(data + head_, length);
+      pending_ = scan_ - head_;
+      return true;
+    }
+  }
+
+  while (true) {
+    size_t available = tail_ - head_;
+    if (discard_ > 0) {
+      // Rest of a dropped frame
+      size_t size = std::min(discard_, available);
+      head_ += size;
+      discard_ -= size;
+      dropped_ += size;
+      Release();
+      if (discard_ > 0) {
+        return false;
+      }
+      continue;
+    }
+    if (available < kLengthPrefixSize) {
+      return false;
+    }
+    const unsigned char* prefix = reinterpret_cast<const unsigned char*>(buffer_.data() + head_);
+    size_t length = (static_cast<size_t>(prefix[0]) << 8) | prefix[1];
+    if (kLengthPrefixSize + length > buffer_.size()) {
+      discard_ = kLengthPrefixSize + length;
+      continue;
+    }
+    if (available < kLengthPrefixSize + length) {
+      return false;
+    }
+    frame = std::string_view(buffer_.data() + head_ + kLengthPrefixSize, length);
+    pending_ = kLengthPrefixSize + length;
+    return true;
+  }
+}
+
+void FrameReceiver::Clear(FrameMode mode) {
+  mode_ = mode;
+  head_ = tail_ = scan_ = pending_ = discard_ = 0;
+  discarding_ = false;
+}
+
+}  // namespace sony::olfactory_device
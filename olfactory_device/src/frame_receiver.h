@@ -0,0 +1,113 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+#define FRAME_RECEIVER_SIZE (4096)  // Default size of the receive buffer, also the largest frame
+
+namespace sony::olfactory_device {
+
+/** How frames are delimited in the received byte stream */
+enum class FrameMode : int32_t {
+  NEWLINE = 0,          /**< Text frames ending with "\n" or "\r\n", empty lines are skipped */
+  LENGTH_PREFIXED = 1,  /**< Binary frames preceded by their length as a 16-bit big-endian integer */
+};
+
+/**
+ * @brief FrameReceiver reassembles the frames of a byte stream without copying them.
+ *
+ * The data is read directly into the receive buffer through WritePointer() and Commit(). Next() hands
+ * out each complete frame as a view into the buffer, whatever the reads it was split across. When the
+ * end of the buffer is reached, the partial frame left is moved back to the start, so frames are always
+ * contiguous. A frame which does not fit in the buffer is dropped.
+ *
+ * Call Next() until it returns false before reading more data. A view returned by Next() stays valid
+ * until the next call of Next(), WritePointer() or Clear().
+ */
+class FrameReceiver {
+ private:
+  std::vector<char> buffer_;  // Receive buffer
+  FrameMode mode_;            // Frame delimitation
+  size_t head_;               // Start of the data not consumed yet
+  size_t tail_;               // End of the received data
+  size_t scan_;               // Position where the search for the next newline resumes
+  size_t pending_;            // Size of the frame handed out by Next(), consumed by the next call
+  size_t discard_;            // Bytes of a dropped length-prefixed frame still to discard
+  bool discarding_;           // Discarding a dropped text frame up to its newline
+  uint64_t dropped_;          // Bytes dropped since construction
+
+  // Releases the frame handed out by Next()
+  void Release();
+
+ public:
+  /**
+   * @brief Constructor.
+   *
+   * @param mode How frames are delimited.
+   * @param size The size of the receive buffer, which bounds the size of a frame.
+   */
+  explicit FrameReceiver(FrameMode mode = FrameMode::NEWLINE, size_t size = FRAME_RECEIVER_SIZE);
+
+  /**
+   * @brief Returns the free space where the next read must write its data.
+   *
+   * @param size Receives the size of the free space, which is never 0.
+   * @return Returns the start of the free space.
+   */
+  char* WritePointer(size_t& size);
+
+  /**
+   * @brief Adds the data written to the free space to the received data.
+   *
+   * @param size The number of bytes written, at most the size returned by WritePointer().
+   */
+  void Commit(size_t size);
+
+  /**
+   * @brief Takes the next complete frame.
+   *
+   * @param frame Receives the frame, without its delimiter or length prefix.
+   * @return Returns true if a complete frame was available, false otherwise.
+   */
+  bool Next(std::string_view& frame);
+
+  /**
+   * @brief Discards all the received data and changes how frames are delimited.
+   *
+   * @param mode How frames are delimited from now on.
+   */
+  void Clear(FrameMode mode);
+
+  /**
+   * @brief Returns the number of bytes dropped because their frame did not fit in the buffer.
+   */
+  uint64_t Dropped() const { return dropped_; }
+
+  /**
+   * @brief Returns how frames are delimited.
+   */
+  FrameMode Mode() const { return mode_; }
+};
+
+}  // namespace sony::olfactory_device
@@ -19,20 +19,36 @@
  */
 
 #include "olfactory_device.h"
+#include "api_stats.h"
+#include "async_log.h"
+#include "availability_notifier.h"
+#include "device_handle_table.h"
+#include "device_registry.h"
 #include "device_session_if.h"
-#include "picojson.h"
+#include "emission_scheduler.h"
+#include "session_table.h"
+#include "timeline_player.h"
 #include "uart_session.h"
+#include "uring_session.h"
 #include "stub_session.h"
 #include "osc_session.h"
+#include "parallel_for.h"
+#include "udp_transmit_batch.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
-#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <iomanip> // for std::setw, std::setfill
 #include <string>
 #include <functional>
+#include <unordered_map>
 
 // Third Party Libraries
 #include <spdlog/spdlog.h>
@@ -43,41 +59,23 @@ namespace sony::olfactory_device {
 // Uncomment to use the StubSession for testing
 #define USE_STUB_SESSION
 //#define USE_UART_SESSION
+//#define USE_URING_SESSION  // Linux only: OSC and serial devices driven through io_uring
+
+#define BULK_SESSION_DEFAULT_PARALLELISM (16)  // Devices opened at the same time by sony_odStartSessions
+#define BULK_EMISSION_DEFAULT_PARALLELISM (1)  // Devices sent to at the same time by sony_odStartScentEmissions
+#define GROUP_EMISSION_TIMETAG_LEAD_US (5000)  // Time between the release of a group and its shared time tag
+#define SCHEDULE_MAX_LEAD_US (86400000000LL)   // Furthest time ahead an emission can be scheduled (24 hours)
 
 #ifdef USE_STUB_SESSION
 using SessionType = StubSession;
 #elif defined(USE_UART_SESSION)
 using SessionType = UartSession;
+#elif defined(USE_URING_SESSION)
+using SessionType = UringSession;
 #else
 using SessionType = OscSession;
 #endif
 
-// Uncomment to use the registry key's path
-//#define USE_JSON_PATH_FROM_REGISTRY_KEY
-
-
-#define FILE_DEVICE_JSON ("C:\\Program Files\\Sony\\Olfactory\\device.json")
-
-// Map to manage DeviceSessionIF instances by device_id
-static std::unordered_map<std::string, std::unique_ptr<DeviceSessionIF>> device_sessions;
-
-// Struct to store emission and cooldown end times
-struct DeviceScent {
-  std::chrono::steady_clock::time_point emission_end_time;  // End of emission
-  std::chrono::steady_clock::time_point cooldown_end_time;  // End of cooldown
-  float duration;                                           // Duration for the current emission
-};
-
-struct DeviceTimes {
-  DeviceScent scent0;
-  DeviceScent scent1;
-  DeviceScent scent2;
-  DeviceScent scent3;
-};
-
-// Map to track the emission and cooldown times for each device
-std::unordered_map<std::string, DeviceTimes> device_next_available_time;
-
 
 // Static wrapper function to call the user-defined log callback
 static void LogCallbackWrapper(const char* message, SonyOzLogSettings_LogLevels level,
@@ -93,6 +91,9 @@ static OdLogCallback g_userLogCallback = nullptr;
 OLFACTORY_DEVICE_API OdResult sony_odRegisterLogCallback(OdLogCallback callback) {
   SonyOzLogSettings_Logger logger;
 
+  // Leave the asynchronous mode, the messages are delivered on the calling thread from now on
+  AsyncLog::GetInstance().Stop();
+
   // Store the user callback in the global variable
   g_userLogCallback = callback;
 
@@ -109,194 +110,410 @@ OLFACTORY_DEVICE_API OdResult sony_odRegisterLogCallback(OdLogCallback callback)
   return OdResult::SUCCESS;
 }
 
-#ifdef USE_JSON_PATH_FROM_REGISTRY_KEY
-/** Get the installation path from a registry key */
-std::wstring GetInstallPath() {
-  HKEY hkey = HKEY_LOCAL_MACHINE;
-  const std::wstring sub_key = std::wstring(L"SOFTWARE\\Sony Corporation\\Olfactory");
-  const std::wstring value = L"Path";
+OLFACTORY_DEVICE_API OdResult sony_odRegisterAsyncLogCallback(OdLogCallback callback, OdLogLevel level) {
+  if (callback == nullptr) {
+    // Deliver the queued messages and go back to the default logger
+    AsyncLog::GetInstance().Stop();
+    return OdResult::SUCCESS;
+  }
+  AsyncLog::GetInstance().Start(callback, level);
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odGetStats(OdStats& stats, bool reset) {
+  if (stats.size < offsetof(OdStats, latency)) {
+    spdlog::error("Invalid size of OdStats: {}", stats.size);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  OdStats snapshot;
+  ApiStats::GetInstance().Snapshot(snapshot, reset);
+
+  // Fill only the fields known by the caller's header
+  snapshot.size = stats.size;
+  std::memcpy(&stats, &snapshot, std::min<size_t>(stats.size, sizeof(OdStats)));
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odGetTime(int64_t& time_us) {
+  time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+  return OdResult::SUCCESS;
+}
 
-  DWORD data_size{};
-  LONG return_code =
-      ::RegGetValueW(hkey, sub_key.c_str(), value.c_str(), RRF_RT_REG_SZ, nullptr, nullptr, &data_size);
-  if (return_code != ERROR_SUCCESS) {
-    return L"";
+OLFACTORY_DEVICE_API OdResult sony_odLoadDeviceConfig(const char* json_path) {
+  DeviceRegistry& registry = DeviceRegistry::GetInstance();
+  bool loaded = (json_path == nullptr) ? registry.Load() : registry.Load(json_path);
+  if (!loaded) {
+    spdlog::error("{}: Failed to load device.json.", __func__);
+    return OdResult::ERROR_UNKNOWN;
   }
 
-  std::wstring data;
-  data.resize(data_size / sizeof(wchar_t));
+  // Resolve the ids again from the new device.json
+  DeviceHandleTable::GetInstance().Reset();
+  return OdResult::SUCCESS;
+}
 
-  return_code =
-      ::RegGetValueW(hkey, sub_key.c_str(), value.c_str(), RRF_RT_REG_SZ, nullptr, &data[0], &data_size);
-  if (return_code != ERROR_SUCCESS) {
-    return L"";
+OLFACTORY_DEVICE_API OdResult sony_odGetDeviceHandle(const char* device_id, int32_t& handle) {
+  if (!DeviceHandleTable::GetInstance().Resolve(device_id, handle)) {
+    spdlog::error("{}: {} : Device is not found in device.json.", device_id, __func__);
+    return OdResult::ERROR_UNKNOWN;
   }
+  return OdResult::SUCCESS;
+}
 
-  DWORD string_length_in_wchars = data_size / sizeof(wchar_t);
+static OdResult CtrlDevice(DeviceSessionIF& session, const std::vector<DeviceCommand>& vec) {
+  ScopedLatency latency(OdStatsApi::SEND_DATA);
+  // Send all the commands together so that the session can pack them into one transmission
+  if (!session.SendDataBatch(vec)) {
+    ApiStats::Count(StatsCounter::SEND_FAILURES);
+    std::cerr << "Failed to send a command." << std::endl;
+    return OdResult::ERROR_UNKNOWN;
+  }
+  ApiStats::Count(StatsCounter::SENT_COMMANDS, vec.size());
+  return OdResult::SUCCESS;
+}
 
-  // Exclude the NULL written by the Win32 API
-  string_length_in_wchars--;
+// Sends the commands in a bundle which the device executes at the given time
+static OdResult CtrlDeviceAt(DeviceSessionIF& session, const std::vector<DeviceCommand>& vec,
+                             std::chrono::steady_clock::time_point time) {
+  ScopedLatency latency(OdStatsApi::SEND_DATA);
+  if (!session.SendDataAt(vec, time)) {
+    ApiStats::Count(StatsCounter::SEND_FAILURES);
+    std::cerr << "Failed to send a command." << std::endl;
+    return OdResult::ERROR_UNKNOWN;
+  }
+  ApiStats::Count(StatsCounter::SENT_COMMANDS, vec.size());
+  return OdResult::SUCCESS;
+}
 
-  data.resize(string_length_in_wchars);
-  return data;
+// Sends one command, recording its latency and result
+static bool SendCommand(DeviceSessionIF& session, const DeviceCommand& command) {
+  ScopedLatency latency(OdStatsApi::SEND_DATA);
+  if (!session.SendData(command)) {
+    ApiStats::Count(StatsCounter::SEND_FAILURES);
+    return false;
+  }
+  ApiStats::Count(StatsCounter::SENT_COMMANDS);
+  return true;
 }
-#endif
 
-std::tuple<std::string, int, int, int> ParseJson(std::string id) {
+// Sends the OSC packets collected during a multi-device call in one go. The tags of the scopes whose
+// packets could not be sent are added to failed_tags if it is not nullptr.
+static void FlushTransmitBatch(UdpTransmitBatch& batch, std::vector<int32_t>* failed_tags = nullptr) {
+  size_t failed = batch.Flush(failed_tags);
+  if (failed > 0) {
+    ApiStats::Count(StatsCounter::SEND_FAILURES, failed);
+    std::cerr << "Failed to send " << failed << " OSC packet(s)." << std::endl;
+  }
+}
 
-// JSON file
-#ifdef USE_JSON_PATH_FROM_REGISTRY_KEY
-  std::wstring directry = GetInstallPath();
-  std::wstring path = directry + L"json\\device.json";
-  std::ifstream inputFile(path);
-#else
-  std::ifstream inputFile(FILE_DEVICE_JSON);
-#endif
+// Returns true if every channel of the device has finished its cooldown at the given time
+static bool CheckAvailable(const DeviceInfo& info, const DeviceTimes& times,
+                           std::chrono::steady_clock::time_point now) {
+  for (int32_t channel : info.channels) {
+    const DeviceScent* scent = times.Find(channel);
+    if (scent != nullptr && now < scent->cooldown_end_time) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the time left until the given time in milliseconds, 0 if the time has passed
+static int32_t GetRemainingMs(std::chrono::steady_clock::time_point time,
+                              std::chrono::steady_clock::time_point now) {
+  if (time <= now) {
+    return 0;
+  }
+  // Round up so that sleeping for the returned time never wakes up too early
+  return static_cast<int32_t>(std::chrono::ceil<std::chrono::milliseconds>(time - now).count());
+}
 
-  if (!inputFile) {
-    std::cerr << "Failed to open device.json." << std::endl;
-    return std::make_tuple("file NG", 0, 0, 0);
-  }
-  std::stringstream buffer;
-  buffer << inputFile.rdbuf();
-  std::string json = buffer.str();
-  // std::cout << json << std::endl;
-
-  // parse JSON
-  picojson::value v;
-  std::string err = picojson::parse(v, json);
-  if (!err.empty()) {
-    std::cerr << "JSON parse error: " << err << std::endl;
-    return std::make_tuple("file NG", 0, 0, 0);
-  }
-
-  std::string ip;
-  int scent0;
-  int scent1;
-  int motor;
-
-  // Get device info
-  const picojson::array& devices = v.get("device").get<picojson::array>();
-  for (const auto& device : devices) {
-    if (id == device.get("id").get<std::string>()) {
-      ip = device.get("ip").get<std::string>();
-      scent0 = static_cast<int>(device.get("scent0").get<double>());
-      scent1 = static_cast<int>(device.get("scent1").get<double>());
-      motor  = static_cast<int>(device.get("motor").get<double>());
+// Returns the times of an emission sent at the given time
+static DeviceScent MakeEmissionTimes(std::chrono::steady_clock::time_point now, float duration, float cooldown) {
+  // Calculate emission_end_time and cooldown_end_time
+  auto emission_end_time = now               + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(duration));
+  auto cooldown_end_time = emission_end_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(cooldown));
+  return {emission_end_time, cooldown_end_time, duration};
+}
+
+// Global variables to store the user-defined availability callback
+static std::mutex g_availabilityMutex;
+static OdAvailabilityCallback g_availabilityCallback = nullptr;
+static void* g_availabilityUserData = nullptr;
+
+// Global variables to store the user-defined emission end callback
+static std::mutex g_emissionEndMutex;
+static OdEmissionEndCallback g_emissionEndCallback = nullptr;
+static void* g_emissionEndUserData = nullptr;
+
+// Called by the timer thread of AvailabilityNotifier when a cooldown of the device ends
+static void OnCooldownEnd(int32_t handle, int32_t channel, AvailabilityNotifier::TimerId id) {
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    return;
+  }
+  DeviceSlot* slot = entry->slot.get();
+
+  bool is_available = false;
+  {
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (!slot->session || !slot->session->IsConnected()) {
+      // The session has ended, the waiters have already been released
+      return;
     }
+    if (channel >= static_cast<int32_t>(slot->times.channels.size()) ||
+        slot->times.channels[channel].cooldown_timer != id) {
+      // The cooldown belongs to an ended session, its timer was cancelled too late
+      return;
+    }
+    slot->times.channels[channel].cooldown_timer = 0;
+    is_available = CheckAvailable(entry->info, slot->times, std::chrono::steady_clock::now());
+  }
+  slot->available.notify_all();
+  if (!is_available) {
+    // Another channel of the device is still cooling down, its own event will follow
+    return;
   }
 
-  return std::make_tuple(ip, scent0, scent1, motor);
+  OdAvailabilityCallback callback = nullptr;
+  void* user_data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(g_availabilityMutex);
+    callback = g_availabilityCallback;
+    user_data = g_availabilityUserData;
+  }
+  if (callback) {
+    callback(entry->id.c_str(), user_data);
+  }
 }
 
-static OdResult CtrlDevice(std::string device, std::vector<std::string> vec) {
-  for (const auto& cmd : vec) {
-    if (!device_sessions[device]->SendData(cmd)) {
-      std::cerr << "Failed to send a command." << std::endl;
-      return OdResult::ERROR_UNKNOWN;
+// Called by the timer thread of AvailabilityNotifier when an emission of the device ends
+static void OnEmissionEnd(int32_t handle, int32_t channel, AvailabilityNotifier::TimerId id) {
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    return;
+  }
+  DeviceSlot* slot = entry->slot.get();
+  {
+    std::lock_guard<std::mutex> lock(slot->mutex);
+    if (!slot->session || !slot->session->IsConnected()) {
+      return;
     }
-//    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    if (channel >= static_cast<int32_t>(slot->times.channels.size()) ||
+        slot->times.channels[channel].emission_timer != id) {
+      // The emission was stopped, its timer was cancelled too late
+      return;
+    }
+    slot->times.channels[channel].emission_timer = 0;
+  }
+
+  auto scent = std::find(entry->info.channels.begin(), entry->info.channels.end(), channel);
+  if (scent == entry->info.channels.end()) {
+    return;
+  }
+  OdEmissionEndCallback callback = nullptr;
+  void* user_data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(g_emissionEndMutex);
+    callback = g_emissionEndCallback;
+    user_data = g_emissionEndUserData;
+  }
+  if (callback) {
+    callback(entry->id.c_str(), static_cast<int32_t>(scent - entry->info.channels.begin()), user_data);
+  }
+}
+
+// Called by the timer thread of AvailabilityNotifier for every event
+static void OnTimer(int32_t handle, int32_t channel, AvailabilityEvent event,
+                    AvailabilityNotifier::TimerId id) {
+  if (event == AvailabilityEvent::EMISSION_END) {
+    OnEmissionEnd(handle, channel, id);
+  } else {
+    OnCooldownEnd(handle, channel, id);
   }
+}
+
+// Schedules the notifications of the end of an emission and of its cooldown. The slot must be locked.
+static void ScheduleTimes(int32_t handle, int32_t channel, DeviceScent& times) {
+  auto now = std::chrono::steady_clock::now();
+  if (times.cooldown_end_time <= now) {
+    // No emission time and no cooldown, the channel never became unavailable
+    return;
+  }
+  static std::once_flag once;
+  AvailabilityNotifier& notifier = AvailabilityNotifier::GetInstance();
+  std::call_once(once, [&notifier]() { notifier.SetHandler(OnTimer); });
+  if (times.emission_end_time > now) {
+    times.emission_timer =
+        notifier.Schedule(handle, channel, AvailabilityEvent::EMISSION_END, times.emission_end_time);
+  }
+  times.cooldown_timer =
+      notifier.Schedule(handle, channel, AvailabilityEvent::COOLDOWN_END, times.cooldown_end_time);
+}
+
+// Called by the thread of EmissionScheduler when the time of a scheduled command is reached
+static void OnScheduledCommand(int32_t handle, uint64_t generation, const DeviceCommand& command) {
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    return;
+  }
+  DeviceSlot* slot = entry->slot.get();
+
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (slot->generation != generation || !slot->session || !slot->session->IsConnected()) {
+    // The session of the command has ended, maybe through another handle of the device
+    return;
+  }
+  if (!SendCommand(*slot->session, command)) {
+    spdlog::error("{}({}): Failed to send a scheduled command.", entry->id, entry->info.ip);
+  }
+}
+
+// Sends the command at the given time from the scheduler thread, unless the session of the slot has ended
+static void ScheduleCommand(int32_t handle, const DeviceSlot& slot, const DeviceCommand& command,
+                            std::chrono::steady_clock::time_point time) {
+  static std::once_flag once;
+  EmissionScheduler& scheduler = EmissionScheduler::GetInstance();
+  std::call_once(once, [&scheduler]() { scheduler.SetHandler(OnScheduledCommand); });
+  scheduler.Schedule(handle, slot.generation, command, time);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odRegisterAvailabilityCallback(OdAvailabilityCallback callback,
+                                                                  void* user_data) {
+  std::lock_guard<std::mutex> lock(g_availabilityMutex);
+  g_availabilityCallback = callback;
+  g_availabilityUserData = user_data;
   return OdResult::SUCCESS;
 }
 
-OLFACTORY_DEVICE_API OdResult sony_odStartSession(const char* device_id) {
-  std::string id(device_id);
-  std::string ip = "";
-  int scent0 = 0;
-  int scent1 = 0;
-  int motor = 0;
+OLFACTORY_DEVICE_API OdResult sony_odRegisterEmissionEndCallback(OdEmissionEndCallback callback,
+                                                                 void* user_data) {
+  std::lock_guard<std::mutex> lock(g_emissionEndMutex);
+  g_emissionEndCallback = callback;
+  g_emissionEndUserData = user_data;
+  return OdResult::SUCCESS;
+}
 
-  std::tie(ip, scent0, scent1, motor) = ParseJson(id);
+OLFACTORY_DEVICE_API OdResult sony_odStartSessionByHandle(int32_t handle) {
+  ScopedLatency latency(OdStatsApi::START_SESSION);
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
   spdlog::debug("{}({}): {} called.", id, ip, __func__);
 
+  std::lock_guard<std::mutex> lock(slot->mutex);
+
   // Check if a session is already active for the given device_id
-  if (device_sessions.find(ip) != device_sessions.end() && device_sessions[ip]->IsConnected()) {
+  if (slot->session && slot->session->IsConnected()) {
     spdlog::debug("{}({}): Session is already active on port", id, ip);
     return OdResult::SUCCESS;
   }
 
-  // Emplace the new SessionType (either StubSession or UartSession)
-  device_sessions.emplace(ip, std::make_unique<SessionType>());
-  DeviceTimes time;
-  device_next_available_time.emplace(ip, time);
+  // Create the new SessionType (StubSession, UartSession, UringSession or OscSession)
+  slot->session = std::make_unique<SessionType>();
+  slot->session->SetProtocol(info.protocol);
+  slot->times = DeviceTimes();
 
   // Open the session for the newly created session instance
-  if (!device_sessions[ip]->Open(ip.c_str())) {
+  if (!slot->session->Open(ip.c_str())) {
     spdlog::error("{}({}): Failed to open connection on port", id, ip);
-    device_sessions.erase(ip);  // Remove if failed
+    slot->session.reset();  // Remove if failed
     return OdResult::ERROR_UNKNOWN;
   }
 
-  std::vector<std::string> vec = {"motor(0, 30)", "motor(1, 30)"};
-  CtrlDevice(ip, vec);
+  std::vector<DeviceCommand> vec = {{CommandOpcode::MOTOR, 0, 30}, {CommandOpcode::MOTOR, 1, 30}};
+  CtrlDevice(*slot->session, vec);
 
   spdlog::debug("{}({}): {} completed.", id, ip, __func__);
   return OdResult::SUCCESS;
 }
 
-OLFACTORY_DEVICE_API OdResult sony_odEndSession(const char* device_id) {
-  std::string id(device_id);
-  std::string ip = "";
-  int scent0 = 0;
-  int scent1 = 0;
-  int motor = 0;
-
-  std::tie(ip, scent0, scent1, motor) = ParseJson(id);
+OLFACTORY_DEVICE_API OdResult sony_odEndSessionByHandle(int32_t handle) {
+  ScopedLatency latency(OdStatsApi::END_SESSION);
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
   spdlog::debug("{}({}): {} called.", id, ip, __func__);
 
   // Check if a session is active for the given device_id
-  if (device_sessions.find(ip) == device_sessions.end() || !device_sessions[ip]->IsConnected()) {
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (!slot->session || !slot->session->IsConnected()) {
     spdlog::error("{}({}): No active session on port", id, ip);
     return OdResult::SUCCESS;
   }
 
-//  std::vector<std::string> vec = {"motor(0, 0)", "motor(1, 0)", "reset(0, 0)"};
-  std::vector<std::string> vec = {"motor(0, 0)", "motor(1, 0)"};
-  CtrlDevice(ip, vec);
-
-  // Close the session and remove it from the map
-  device_sessions[ip]->Close();
-  device_sessions.erase(ip);
-
-  // Check if the device has an active start time
-  auto it = device_next_available_time.find(ip);
-  if (it != device_next_available_time.end()) {
-    device_next_available_time.erase(it);
+//  std::vector<DeviceCommand> vec = {{CommandOpcode::MOTOR, 0, 0}, {CommandOpcode::MOTOR, 1, 0}, {CommandOpcode::RESET, 0, 0}};
+  std::vector<DeviceCommand> vec = {{CommandOpcode::MOTOR, 0, 0}, {CommandOpcode::MOTOR, 1, 0}};
+  CtrlDevice(*slot->session, vec);
+
+  // Drop the emissions scheduled on the host, a new session must not send them. The generation discards
+  // those scheduled through the other handles of the device, e.g. handles resolved before a reload.
+  slot->generation++;
+  EmissionScheduler::GetInstance().Cancel(handle);
+  // The emissions which have not ended will not report their end, nor their cooldowns
+  for (const DeviceScent& times : slot->times.channels) {
+    if (times.emission_timer != 0) {
+      AvailabilityNotifier::GetInstance().Cancel(times.emission_timer);
+    }
+    if (times.cooldown_timer != 0) {
+      AvailabilityNotifier::GetInstance().Cancel(times.cooldown_timer);
+    }
   }
 
+  // Close the session and clear the emission times of the device
+  slot->session->Close();
+  slot->session.reset();
+  slot->times = DeviceTimes();
+  // Release the waiters, the session is gone
+  slot->available.notify_all();
+
   spdlog::debug("{}({}): {} completed.", id, ip, __func__);
   return OdResult::SUCCESS;
 }
 
 OLFACTORY_DEVICE_API OdResult sony_odSetScentOrientation(const char* device_id, float yaw, float pitch) {
-  std::string id(device_id);
-  std::string ip = "";
-  int scent0 = 0;
-  int scent1 = 0;
-  int motor = 0;
-
-  std::tie(ip, scent0, scent1, motor) = ParseJson(id);
+  int32_t handle = 0;
+  if (!DeviceHandleTable::GetInstance().Resolve(device_id, handle)) {
+    spdlog::error("{}: {} : Device is not found in device.json.", device_id, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  const std::string& id = entry->id;
+  const std::string& ip = entry->info.ip;
   spdlog::debug("{}({}): {} called.", id, ip, __func__);
   spdlog::debug("{}({}): {} completed.", id, ip, __func__);
   return OdResult::ERROR_FUNCTION_UNSUPPORTED;
 }
 
-OLFACTORY_DEVICE_API OdResult sony_odStartScentEmission(const char* device_id, const char* scent_name, float duration, bool& is_available) {
-  std::string id(device_id);
-  std::string ip = "";
-  int scent0 = 0;
-  int scent1 = 0;
-  int motor = 0;
-
-  std::tie(ip, scent0, scent1, motor) = ParseJson(id);
+OLFACTORY_DEVICE_API OdResult sony_odStartScentEmissionByHandle(int32_t handle, int32_t scent, float duration, bool& is_available) {
+  ScopedLatency latency(OdStatsApi::START_SCENT_EMISSION);
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
   spdlog::debug("{}({}): {} called.", id, ip, __func__);
 
-  std::string scent(scent_name);
-  int i_scent = std::stoi(scent);
-
   // Check if a session is active for the given device_id
-  if (device_sessions.find(ip) == device_sessions.end() || !device_sessions[ip]->IsConnected()) {
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (!slot->session || !slot->session->IsConnected()) {
     spdlog::error("{}({}): No active session on port. Start a session first.", id, ip);
     return OdResult::ERROR_UNKNOWN;
   }
@@ -305,166 +522,466 @@ OLFACTORY_DEVICE_API OdResult sony_odStartScentEmission(const char* device_id, c
   duration = std::clamp(duration, 0.0f, 10.0f);
   // Get the current time
   auto now = std::chrono::steady_clock::now();
-  // Check the last start time for the given device
-  auto it = device_next_available_time.find(ip);
-  if (it != device_next_available_time.end()) {
-    if (i_scent == 0 && scent0 == 0) {
-      now = std::chrono::steady_clock::now();
-      if (now < it->second.scent0.cooldown_end_time) {
-        // Device is still unavailable
-        is_available = false;
-        spdlog::debug("{}({}): {} Device is still unavailable.", id, ip, __func__);
-        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-        std::cout << "[OscSession] Data sent: " << id << "(" << ip << ")" << "Device is still unavailable." << std::endl;
-        SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-        return OdResult::SUCCESS;
-      } else {
-        is_available = false;
-        std::string command = "release(0," + std::to_string(static_cast<int>(duration)) + ")";
-        if (!device_sessions[ip]->SendData(command)) {
-          spdlog::error("{}({}): Failed to set SCENT.", id, ip);
-          return OdResult::ERROR_UNKNOWN;
-        }
-        // Calculate emission_end_time and cooldown_end_time
-        now = std::chrono::steady_clock::now();
-        auto emission_end_time = now               + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(duration));
-        auto cooldown_end_time = emission_end_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(6.0f));
-        // Update the times and duration for the device
-        device_next_available_time[ip].scent0 = {emission_end_time, cooldown_end_time, duration};
-      }
+  // Look up the channel of the scent and its last emission
+  if (scent < 0 || scent >= static_cast<int32_t>(info.channels.size())) {
+    spdlog::error("{}({}): {} : Scent {} is not configured in device.json.", id, ip, __func__, scent);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  int32_t channel = info.channels[scent];
+  DeviceScent& times = slot->times.At(channel);
+  if (now < times.cooldown_end_time) {
+    // Device is still unavailable
+    is_available = false;
+    ApiStats::Count(StatsCounter::COOLDOWN_REJECTIONS);
+    spdlog::debug("{}({}): {} Device is still unavailable.", id, ip, __func__);
+    ConsoleLog(FOREGROUND_GREEN | FOREGROUND_INTENSITY,
+               "[OscSession] Data sent: {}({})Device is still unavailable.", id, ip);
+    return OdResult::SUCCESS;
+  }
+
+  is_available = false;
+  DeviceCommand command = {CommandOpcode::RELEASE, channel, static_cast<int32_t>(duration)};
+  if (!SendCommand(*slot->session, command)) {
+    spdlog::error("{}({}): Failed to set SCENT.", id, ip);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  // Update the times and duration for the channel
+  times = MakeEmissionTimes(std::chrono::steady_clock::now(), duration, info.cooldowns[scent]);
+  // Call the emission end callback, then wake the waiters and call the availability callback when the
+  // cooldown ends
+  ScheduleTimes(handle, channel, times);
+
+  spdlog::debug("{}({}): {} completed.", id, ip, __func__);
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odScheduleScentEmissionByHandle(int32_t handle, int32_t scent,
+                                                                   float duration, int64_t time_us,
+                                                                   bool& is_available) {
+  ScopedLatency latency(OdStatsApi::SCHEDULE_SCENT_EMISSION);
+  is_available = false;
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
+  spdlog::debug("{}({}): {} called.", id, ip, __func__);
+
+  // Check if a session is active for the given device_id
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (!slot->session || !slot->session->IsConnected()) {
+    spdlog::error("{}({}): No active session on port. Start a session first.", id, ip);
+    return OdResult::ERROR_UNKNOWN;
+  }
+
+  // Clamp the duration to the range [0, 10]
+  duration = std::clamp(duration, 0.0f, 10.0f);
+  if (scent < 0 || scent >= static_cast<int32_t>(info.channels.size())) {
+    spdlog::error("{}({}): {} : Scent {} is not configured in device.json.", id, ip, __func__, scent);
+    return OdResult::ERROR_UNKNOWN;
+  }
+
+  // A time in the past starts the emission now. The time is checked in microseconds, so that a time out
+  // of the range of the clock is rejected instead of overflowing its nanoseconds.
+  auto now = std::chrono::steady_clock::now();
+  int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+  if (time_us > now_us + SCHEDULE_MAX_LEAD_US) {
+    spdlog::error("{}({}): {} : Time {} us is too far ahead.", id, ip, __func__, time_us);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  auto time = (time_us <= now_us) ? now
+                                  : std::chrono::steady_clock::time_point(std::chrono::microseconds(time_us));
+  int32_t channel = info.channels[scent];
+  DeviceScent& times = slot->times.At(channel);
+  if (time < times.cooldown_end_time) {
+    // The channel is still unavailable at the requested time
+    is_available = false;
+    ApiStats::Count(StatsCounter::COOLDOWN_REJECTIONS);
+    spdlog::debug("{}({}): {} Device is still unavailable.", id, ip, __func__);
+    return OdResult::SUCCESS;
+  }
+
+  // Devices which honor the time tags receive the command now, the others when the time is reached
+  DeviceCommand command = {CommandOpcode::RELEASE, channel, static_cast<int32_t>(duration)};
+  if (info.timetags && slot->session->SupportsTimeTags()) {
+    if (CtrlDeviceAt(*slot->session, {command}, time) != OdResult::SUCCESS) {
+      spdlog::error("{}({}): Failed to set SCENT.", id, ip);
+      return OdResult::ERROR_UNKNOWN;
     }
-    
-    if (i_scent == 1 && scent1 == 1) {
-      now = std::chrono::steady_clock::now();
-      if (now < it->second.scent1.cooldown_end_time) {
-        // Device is still unavailable
-        is_available = false;
-        spdlog::debug("{}({}): {} Device is still unavailable.", id, ip, __func__);
-        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-        std::cout << "[OscSession] Data sent: " << id << "(" << ip << ")" << "Device is still unavailable." << std::endl;
-        SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-        return OdResult::SUCCESS;
-      } else {
-        is_available = false;
-        std::string command = "release(1," + std::to_string(static_cast<int>(duration)) + ")";
-        if (!device_sessions[ip]->SendData(command)) {
-          spdlog::error("{}({}): Failed to set SCENT.", id, ip);
-          return OdResult::ERROR_UNKNOWN;
-        }
-        // Calculate emission_end_time and cooldown_end_time
-        now = std::chrono::steady_clock::now();
-        auto emission_end_time = now               + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(duration));
-        auto cooldown_end_time = emission_end_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(6.0f));
-        // Update the times and duration for the device
-        device_next_available_time[ip].scent1 = {emission_end_time, cooldown_end_time, duration};
-      }
+  } else {
+    ScheduleCommand(handle, *slot, command, time);
+  }
+
+  // The channel is reserved from now, its times start at the scheduled time
+  times = MakeEmissionTimes(time, duration, info.cooldowns[scent]);
+  ScheduleTimes(handle, channel, times);
+  is_available = true;
+
+  spdlog::debug("{}({}): {} completed.", id, ip, __func__);
+  return OdResult::SUCCESS;
+}
+
+// Emission of sony_odStartScentEmissions, resolved to its device
+struct BatchEmission {
+  int32_t index;                   // Index in the arrays of the caller
+  int32_t handle;                  // Handle of the device
+  const DeviceHandleEntry* entry;  // Device of the handle
+};
+
+// Commands of one device which passed the cooldown check, see StageBatch
+struct StagedBatch {
+  std::vector<DeviceCommand> commands;         // Commands to send, one per accepted emission
+  std::vector<const BatchEmission*> accepted;  // Emission of each command
+};
+
+// Checks the cooldowns of the entries of one device and builds their commands. The slot must be locked.
+// Returns false if the device has no session.
+static bool StageBatch(const OdScentEmission* emissions, const BatchEmission* batch, size_t size,
+                       OdResult* results, StagedBatch& staged) {
+  DeviceSlot* slot = batch[0].entry->slot.get();
+  if (!slot->session || !slot->session->IsConnected()) {
+    spdlog::error("{}({}): {} : No active session on port. Start a session first.", batch[0].entry->id,
+                  batch[0].entry->info.ip, __func__);
+    return false;
+  }
+
+  // Check the cooldowns, a channel emitted twice in the batch is rejected the second time
+  auto now = std::chrono::steady_clock::now();
+  std::vector<DeviceCommand>& commands = staged.commands;
+  for (size_t i = 0; i < size; i++) {
+    const BatchEmission& emission = batch[i];
+    const DeviceInfo& info = emission.entry->info;
+    int32_t scent = emissions[emission.index].scent;
+    if (scent < 0 || scent >= static_cast<int32_t>(info.channels.size())) {
+      spdlog::error("{}({}): {} : Scent {} is not configured in device.json.", emission.entry->id, info.ip,
+                    __func__, scent);
+      continue;
+    }
+    int32_t channel = info.channels[scent];
+    const DeviceScent* times = slot->times.Find(channel);
+    bool emitting = std::any_of(commands.begin(), commands.end(),
+                                [channel](const DeviceCommand& command) { return command.target == channel; });
+    results[emission.index] = OdResult::SUCCESS;
+    if ((times != nullptr && now < times->cooldown_end_time) || emitting) {
+      spdlog::debug("{}({}): {} Device is still unavailable.", emission.entry->id, info.ip, __func__);
+      ApiStats::Count(StatsCounter::COOLDOWN_REJECTIONS);
+      continue;
     }
+    float duration = std::clamp(emissions[emission.index].duration, 0.0f, 10.0f);
+    commands.push_back({CommandOpcode::RELEASE, channel, static_cast<int32_t>(duration)});
+    staged.accepted.push_back(&emission);
+  }
+  return true;
+}
 
-    if (i_scent == 0 && scent0 == 2) {
-      now = std::chrono::steady_clock::now();
-      if (now < it->second.scent2.cooldown_end_time) {
-        // Device is still unavailable
-        is_available = false;
-        spdlog::debug("{}({}): {} Device is still unavailable.", id, ip, __func__);
-        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-        std::cout << "[OscSession] Data sent: " << id << "(" << ip << ")" << "Device is still unavailable." << std::endl;
-        SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-        return OdResult::SUCCESS;
-      } else {
-        is_available = false;
-        std::string command = "release(2," + std::to_string(static_cast<int>(duration)) + ")";
-        if (!device_sessions[ip]->SendData(command)) {
-          spdlog::error("{}({}): Failed to set SCENT.", id, ip);
-          return OdResult::ERROR_UNKNOWN;
-        }
-        // Calculate emission_end_time and cooldown_end_time
-        now = std::chrono::steady_clock::now();
-        auto emission_end_time = now               + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(duration));
-        auto cooldown_end_time = emission_end_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(6.0f));
-        // Update the times and duration for the device
-        device_next_available_time[ip].scent2 = {emission_end_time, cooldown_end_time, duration};
-      }
+// Records the times of the staged emissions of one device, started at the given time.
+// The slot must be locked.
+static void CommitBatch(const OdScentEmission* emissions, const StagedBatch& staged,
+                        std::chrono::steady_clock::time_point time, bool* is_available) {
+  for (size_t i = 0; i < staged.accepted.size(); i++) {
+    const BatchEmission& emission = *staged.accepted[i];
+    float duration = std::clamp(emissions[emission.index].duration, 0.0f, 10.0f);
+    float cooldown = emission.entry->info.cooldowns[emissions[emission.index].scent];
+    DeviceScent& times = emission.entry->slot->times.At(staged.commands[i].target);
+    times = MakeEmissionTimes(time, duration, cooldown);
+    ScheduleTimes(emission.handle, staged.commands[i].target, times);
+    is_available[emission.index] = true;
+  }
+}
+
+// Marks the staged emissions of one device as failed, so that CommitBatch skips them
+static void FailBatch(StagedBatch& staged, OdResult* results) {
+  for (const BatchEmission* emission : staged.accepted) {
+    results[emission->index] = OdResult::ERROR_UNKNOWN;
+  }
+  staged.accepted.clear();
+}
+
+// Marks the staged emissions of one device as failed once its OSC packets could not be sent
+static void FailFlushedBatch(StagedBatch& staged, OdResult* results) {
+  if (!staged.accepted.empty()) {
+    const DeviceHandleEntry* entry = staged.accepted[0]->entry;
+    spdlog::error("{}({}): Failed to send SCENT.", entry->id, entry->info.ip);
+    FailBatch(staged, results);
+  }
+}
+
+// Stages the entries of one device and sends their commands in one transmission. The slot must be locked.
+static void EmitBatch(const OdScentEmission* emissions, const BatchEmission* batch, size_t size,
+                      OdResult* results, StagedBatch& staged) {
+  DeviceSlot* slot = batch[0].entry->slot.get();
+  if (!StageBatch(emissions, batch, size, results, staged) || staged.commands.empty()) {
+    return;
+  }
+
+  // All the emissions of the device go out together
+  if (CtrlDevice(*slot->session, staged.commands) != OdResult::SUCCESS) {
+    spdlog::error("{}({}): Failed to set SCENT.", batch[0].entry->id, batch[0].entry->info.ip);
+    FailBatch(staged, results);
+  }
+}
+
+// Resolves the devices of the emissions and groups the entries by device, keeping the order of the caller
+// within a device. Returns the start of each group in batch, followed by the size of batch.
+static std::vector<size_t> ResolveBatch(const OdScentEmission* emissions, int32_t count, bool* is_available,
+                                        OdResult* results, std::vector<BatchEmission>& batch) {
+  DeviceHandleTable& table = DeviceHandleTable::GetInstance();
+  batch.reserve(count);
+  for (int32_t i = 0; i < count; i++) {
+    is_available[i] = false;
+    results[i] = OdResult::ERROR_UNKNOWN;
+    int32_t handle = 0;
+    if (emissions[i].device_id == nullptr || !table.Resolve(emissions[i].device_id, handle)) {
+      spdlog::error("{}: {} : Device is not found in device.json.",
+                    emissions[i].device_id ? emissions[i].device_id : "(null)", __func__);
+      continue;
     }
+    batch.push_back({i, handle, table.Get(handle)});
+  }
 
-    if (i_scent == 1 && scent1 == 3) {
-      now = std::chrono::steady_clock::now();
-      if (now < it->second.scent3.cooldown_end_time) {
-        // Device is still unavailable
-        is_available = false;
-        spdlog::debug("{}({}): {} Device is still unavailable.", id, ip, __func__);
-        HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-        SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-        std::cout << "[OscSession] Data sent: " << id << "(" << ip << ")" << "Device is still unavailable." << std::endl;
-        SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-        return OdResult::SUCCESS;
-      } else {
-        is_available = false;
-        std::string command = "release(3," + std::to_string(static_cast<int>(duration)) + ")";
-        if (!device_sessions[ip]->SendData(command)) {
-          spdlog::error("{}({}): Failed to set SCENT.", id, ip);
-          return OdResult::ERROR_UNKNOWN;
-        }
-        // Calculate emission_end_time and cooldown_end_time
-        now = std::chrono::steady_clock::now();
-        auto emission_end_time = now               + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(duration));
-        auto cooldown_end_time = emission_end_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(6.0f));
-        // Update the times and duration for the device
-        device_next_available_time[ip].scent3 = {emission_end_time, cooldown_end_time, duration};
-      }
+  std::stable_sort(batch.begin(), batch.end(), [](const BatchEmission& a, const BatchEmission& b) {
+    return std::less<const DeviceSlot*>()(a.entry->slot.get(), b.entry->slot.get());
+  });
+  std::vector<size_t> groups;
+  for (size_t i = 0; i < batch.size(); i++) {
+    if (i == 0 || batch[i].entry->slot != batch[i - 1].entry->slot) {
+      groups.push_back(i);
+    }
+  }
+  groups.push_back(batch.size());
+  return groups;
+}
+
+// Returns SUCCESS if every emission succeeded, even if it was rejected
+static OdResult CombineResults(const OdResult* results, int32_t count) {
+  for (int32_t i = 0; i < count; i++) {
+    if (results[i] != OdResult::SUCCESS) {
+      return OdResult::ERROR_UNKNOWN;
     }
   }
-  spdlog::debug("{}({}): {} completed.", id, ip, __func__);
   return OdResult::SUCCESS;
 }
 
-OLFACTORY_DEVICE_API OdResult sony_odStopScentEmission(const char* device_id) {
-  std::string id(device_id);
-  std::string ip = "";
-  int scent0 = 0;
-  int scent1 = 0;
-  int motor = 0;
+OLFACTORY_DEVICE_API OdResult sony_odStartScentEmissions(const OdScentEmission* emissions, int32_t count,
+                                                         int32_t parallelism, bool* is_available,
+                                                         OdResult* results) {
+  ScopedLatency latency(OdStatsApi::START_SCENT_EMISSIONS);
+  if (emissions == nullptr || count < 0 || is_available == nullptr || results == nullptr) {
+    spdlog::error("{}: Invalid emission list.", __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  if (parallelism <= 0) {
+    parallelism = BULK_EMISSION_DEFAULT_PARALLELISM;
+  }
+
+  std::vector<BatchEmission> batch;
+  std::vector<size_t> groups = ResolveBatch(emissions, count, is_available, results, batch);
+
+  // The devices stay locked until their OSC packets are out, so that no other call can send to them in
+  // between. The batch is sorted by slot, which gives every batch call the same locking order.
+  int32_t device_count = static_cast<int32_t>(groups.size() - 1);
+  std::vector<std::unique_lock<std::mutex>> locks;
+  locks.reserve(device_count);
+  for (int32_t group = 0; group < device_count; group++) {
+    locks.emplace_back(batch[groups[group]].entry->slot->mutex);
+  }
+
+  // The OSC packets of all the devices are sent together once every group is done
+  std::vector<StagedBatch> staged(device_count);
+  UdpTransmitBatch transmit;
+  ParallelFor(device_count, parallelism, [&](int32_t group) {
+    UdpTransmitBatch::Scope scope(transmit, group);
+    EmitBatch(emissions, &batch[groups[group]], groups[group + 1] - groups[group], results, staged[group]);
+  });
+  std::vector<int32_t> failed_tags;
+  FlushTransmitBatch(transmit, &failed_tags);
+  for (int32_t group : failed_tags) {
+    FailFlushedBatch(staged[group], results);
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  for (const StagedBatch& device : staged) {
+    CommitBatch(emissions, device, now, is_available);
+  }
+
+  return CombineResults(results, count);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odStartGroupScentEmission(const OdScentEmission* emissions, int32_t count,
+                                                             bool* is_available, OdResult* results,
+                                                             OdGroupEmission& group) {
+  ScopedLatency latency(OdStatsApi::START_GROUP_SCENT_EMISSION);
+  if (emissions == nullptr || count < 0 || is_available == nullptr || results == nullptr) {
+    spdlog::error("{}: Invalid emission list.", __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  group = {};
+
+  std::vector<BatchEmission> batch;
+  std::vector<size_t> groups = ResolveBatch(emissions, count, is_available, results, batch);
+
+  // Stage the commands of every device. The devices stay locked until the release so that no other call
+  // can send to them or take their channels in between. The batch is sorted by slot, which gives every
+  // group call the same locking order.
+  struct StagedDevice {
+    const BatchEmission* batch;  // First entry of the device
+    StagedBatch staged;          // Commands of the device
+  };
+  std::vector<std::unique_lock<std::mutex>> locks;
+  std::vector<StagedDevice> devices;
+  locks.reserve(groups.size() - 1);
+  devices.reserve(groups.size() - 1);
+  bool time_tagged = true;
+  for (size_t i = 0; i + 1 < groups.size(); i++) {
+    const BatchEmission* first = &batch[groups[i]];
+    std::unique_lock<std::mutex> lock(first->entry->slot->mutex);
+    StagedBatch staged;
+    size_t size = groups[i + 1] - groups[i];
+    if (!StageBatch(emissions, first, size, results, staged) || staged.commands.empty()) {
+      continue;
+    }
+    time_tagged = time_tagged && first->entry->info.timetags &&
+                  first->entry->slot->session->SupportsTimeTags();
+    locks.push_back(std::move(lock));
+    devices.push_back({first, std::move(staged)});
+  }
+  if (devices.empty()) {
+    return CombineResults(results, count);
+  }
+
+  // Release every device at once. Devices which honor the time tags all get the same time, slightly ahead
+  // of the transmissions. The others start when their packet arrives, the OSC packets leave in one flush.
+  UdpTransmitBatch transmit;
+  auto release = std::chrono::steady_clock::now();
+  auto time = time_tagged ? release + std::chrono::microseconds(GROUP_EMISSION_TIMETAG_LEAD_US) : release;
+  for (size_t i = 0; i < devices.size(); i++) {
+    UdpTransmitBatch::Scope scope(transmit, static_cast<int32_t>(i));
+    StagedDevice& device = devices[i];
+    DeviceSessionIF& session = *device.batch->entry->slot->session;
+    OdResult result = time_tagged ? CtrlDeviceAt(session, device.staged.commands, time)
+                                  : CtrlDevice(session, device.staged.commands);
+    if (result != OdResult::SUCCESS) {
+      spdlog::error("{}({}): Failed to set SCENT.", device.batch->entry->id, device.batch->entry->info.ip);
+      FailBatch(device.staged, results);
+    }
+  }
+  std::vector<int32_t> failed_tags;
+  FlushTransmitBatch(transmit, &failed_tags);
+  for (int32_t device : failed_tags) {
+    FailFlushedBatch(devices[device].staged, results);
+  }
+  auto sent = std::chrono::steady_clock::now();
 
-  std::tie(ip, scent0, scent1, motor) = ParseJson(id);
+  // The first device starts at the release and the last one once every packet is out, unless the
+  // shared time tag holds all of them until a time after the last packet
+  if (!time_tagged) {
+    time = sent;
+  }
+  auto skew = sent - release;
+  if (time_tagged) {
+    skew = std::max(sent - time, std::chrono::steady_clock::duration::zero());
+  }
+  group.start_us = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+  group.skew_us = std::chrono::duration_cast<std::chrono::microseconds>(skew).count();
+  group.time_tagged = time_tagged;
+  for (const StagedDevice& device : devices) {
+    if (!device.staged.accepted.empty()) {
+      group.devices++;
+    }
+    CommitBatch(emissions, device.staged, time, is_available);
+  }
+  spdlog::debug("{}: {} device(s) released, skew {} us{}.", __func__, group.devices, group.skew_us,
+                time_tagged ? " (time-tagged)" : "");
+
+  return CombineResults(results, count);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odStopScentEmissionByHandle(int32_t handle) {
+  ScopedLatency latency(OdStatsApi::STOP_SCENT_EMISSION);
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
   spdlog::debug("{}({}): {} called.", id, ip, __func__);
 
   // Check if a session is active for the given device_id
-  if (device_sessions.find(ip) == device_sessions.end() || !device_sessions[ip]->IsConnected()) {
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (!slot->session || !slot->session->IsConnected()) {
     spdlog::error("{}({}): No active session on port. Start a session first.", id, ip);
     return OdResult::ERROR_UNKNOWN;
   }
 
-  std::string command;
-  command = "release(" + std::to_string(scent0) + ", 0)";
-  if (!device_sessions[ip]->SendData(command)) {
+  std::vector<DeviceCommand> vec;
+  for (int32_t channel : info.channels) {
+    vec.push_back({CommandOpcode::RELEASE, channel, 0});
+  }
+  if (CtrlDevice(*slot->session, vec) != OdResult::SUCCESS) {
     spdlog::error("{}({}): Failed to set SCENT.", id, ip);
     return OdResult::ERROR_UNKNOWN;
   }
 
-  command = "release(" + std::to_string(scent1) + ", 0)";
-  if (!device_sessions[ip]->SendData(command)) {
-    spdlog::error("{}({}): Failed to set SCENT.", id, ip);
-    return OdResult::ERROR_UNKNOWN;
+  // Drop the emissions scheduled on the host. Those sent with an OSC time tag are on the device already.
+  bool recalled = !(info.timetags && slot->session->SupportsTimeTags());
+  if (recalled) {
+    slot->generation++;
+    EmissionScheduler::GetInstance().Cancel(handle);
   }
 
+  // The emissions end now, their emission end callbacks are not called. The cooldowns are unchanged,
+  // except for the emissions dropped before their start, which release their channel.
+  auto now = std::chrono::steady_clock::now();
+  for (int32_t channel : info.channels) {
+    if (slot->times.Find(channel) == nullptr) {
+      continue;
+    }
+    DeviceScent& times = slot->times.At(channel);
+    if (times.emission_timer != 0) {
+      AvailabilityNotifier::GetInstance().Cancel(times.emission_timer);
+      times.emission_timer = 0;
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(times.duration));
+    if (recalled && times.emission_end_time - duration > now) {
+      if (times.cooldown_timer != 0) {
+        AvailabilityNotifier::GetInstance().Cancel(times.cooldown_timer);
+      }
+      times = DeviceScent();
+      continue;
+    }
+    times.emission_end_time = std::min(times.emission_end_time, now);
+  }
+  // Wake the waiters of the released channels
+  slot->available.notify_all();
+
   spdlog::debug("{}({}): {} completed.", id, ip, __func__);
   return OdResult::SUCCESS;
 }
 
-OLFACTORY_DEVICE_API OdResult sony_odIsScentEmissionAvailable(const char* device_id, bool& is_available) {
-  std::string id(device_id);
-  std::string ip = "";
-  int scent0 = 0;
-  int scent1 = 0;
-  int motor = 0;
-
-  std::tie(ip, scent0, scent1, motor) = ParseJson(id);
+OLFACTORY_DEVICE_API OdResult sony_odIsScentEmissionAvailableByHandle(int32_t handle, bool& is_available) {
+  ScopedLatency latency(OdStatsApi::IS_SCENT_EMISSION_AVAILABLE);
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
 //  spdlog::debug("{}({}): {} called.", id, ip, __func__);
 
   // Check if a session is active for the given device_id
-  if (device_sessions.find(ip) == device_sessions.end() || !device_sessions[ip]->IsConnected()) {
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (!slot->session || !slot->session->IsConnected()) {
     spdlog::error("{}({}): {} : No active session on port. Start a session first.", id, ip, __func__);
     return OdResult::ERROR_UNKNOWN;
   }
@@ -472,59 +989,362 @@ OLFACTORY_DEVICE_API OdResult sony_odIsScentEmissionAvailable(const char* device
   // Get the current time
   auto now = std::chrono::steady_clock::now();
 
-  // Check the last start time for the given device
-  auto it = device_next_available_time.find(ip);
-  if (it != device_next_available_time.end()) {
+  is_available = CheckAvailable(info, slot->times, now);
 
-    bool flag_scent0 = true;
-    bool flag_scent1 = true;
-    bool flag_scent2 = true;
-    bool flag_scent3 = true;
+  // Check if scent emission is available
+//  is_available = slot->session->IsScentEmissionAvailable();
 
-    if (scent0 == 0) {
-      if (now < it->second.scent0.cooldown_end_time) {
-        flag_scent0 = false;
-      } else {
-        flag_scent0 = true;
-      }
+//  spdlog::debug("{}({}): {} completed.", id, ip, __func__);
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odWaitScentEmissionAvailableByHandle(int32_t handle, int32_t timeout_ms,
+                                                                        bool& is_available) {
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
+  spdlog::debug("{}({}): {} called.", id, ip, __func__);
+
+  // Check if a session is active for the given device_id
+  std::unique_lock<std::mutex> lock(slot->mutex);
+  if (!slot->session || !slot->session->IsConnected()) {
+    spdlog::error("{}({}): {} : No active session on port. Start a session first.", id, ip, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+
+  // Sleep until the timer thread reports the end of the cooldown or the session ends
+  auto ready = [slot, &info]() {
+    if (!slot->session || !slot->session->IsConnected()) {
+      return true;
     }
+    return CheckAvailable(info, slot->times, std::chrono::steady_clock::now());
+  };
+  if (timeout_ms < 0) {
+    slot->available.wait(lock, ready);
+  } else {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    slot->available.wait_until(lock, deadline, ready);
+  }
 
-    if (scent1 == 1) {
-      if (now < it->second.scent1.cooldown_end_time) {
-        flag_scent1 = false;
-      } else {
-        flag_scent1 = true;
-      }
+  if (!slot->session || !slot->session->IsConnected()) {
+    spdlog::error("{}({}): {} : Session ended while waiting.", id, ip, __func__);
+    is_available = false;
+    return OdResult::ERROR_UNKNOWN;
+  }
+  is_available = CheckAvailable(info, slot->times, std::chrono::steady_clock::now());
+
+  spdlog::debug("{}({}): {} completed.", id, ip, __func__);
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odGetScentEmissionTimesByHandle(int32_t handle, OdScentTime* times,
+                                                                   int32_t capacity, int32_t& count) {
+  ScopedLatency latency(OdStatsApi::GET_SCENT_EMISSION_TIMES);
+  const DeviceHandleEntry* entry = DeviceHandleTable::GetInstance().Get(handle);
+  if (entry == nullptr) {
+    spdlog::error("{}: {} : Invalid device handle.", handle, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  const std::string& id = entry->id;
+  const DeviceInfo& info = entry->info;
+  const std::string& ip = info.ip;
+  DeviceSlot* slot = entry->slot.get();
+
+  if (times == nullptr && capacity > 0) {
+    spdlog::error("{}({}): {} : times is nullptr.", id, ip, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+
+  // Check if a session is active for the given device_id
+  std::lock_guard<std::mutex> lock(slot->mutex);
+  if (!slot->session || !slot->session->IsConnected()) {
+    spdlog::error("{}({}): {} : No active session on port. Start a session first.", id, ip, __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  count = static_cast<int32_t>(info.channels.size());
+  for (int32_t i = 0; i < count && i < capacity; i++) {
+    // A channel which has never emitted has no remaining time
+    const DeviceScent* found = slot->times.Find(info.channels[i]);
+    const DeviceScent scent = (found != nullptr) ? *found : DeviceScent();
+    times[i].scent = i;
+    times[i].emission_remaining_ms = GetRemainingMs(scent.emission_end_time, now);
+    times[i].cooldown_remaining_ms = GetRemainingMs(scent.cooldown_end_time, now);
+  }
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odStartSession(const char* device_id) {
+  int32_t handle = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odStartSessionByHandle(handle);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odEndSession(const char* device_id) {
+  int32_t handle = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odEndSessionByHandle(handle);
+}
+
+// Calls a session function for each device from up to parallelism threads and stores the results
+template <typename Function>
+static OdResult ForEachDevice(const char* const* device_ids, int32_t count, int32_t parallelism,
+                              OdResult* results, const Function& function) {
+  if (device_ids == nullptr || count < 0) {
+    spdlog::error("{}: Invalid device list.", __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  if (parallelism <= 0) {
+    parallelism = BULK_SESSION_DEFAULT_PARALLELISM;
+  }
+
+  std::atomic<bool> failed(false);
+  UdpTransmitBatch transmit;
+  ParallelFor(count, parallelism, [&](int32_t index) {
+    UdpTransmitBatch::Scope scope(transmit);
+    OdResult result = (device_ids[index] != nullptr) ? function(device_ids[index]) : OdResult::ERROR_UNKNOWN;
+    if (results != nullptr) {
+      results[index] = result;
+    }
+    if (result != OdResult::SUCCESS) {
+      failed = true;
     }
+  });
+  FlushTransmitBatch(transmit);
+  return failed ? OdResult::ERROR_UNKNOWN : OdResult::SUCCESS;
+}
 
-    if (scent0 == 2) {
-      if (now < it->second.scent2.cooldown_end_time) {
-        flag_scent2 = false;
-      } else {
-        flag_scent2 = true;
-      }
+OLFACTORY_DEVICE_API OdResult sony_odStartSessions(const char* const* device_ids, int32_t count,
+                                                   int32_t parallelism, OdResult* results) {
+  return ForEachDevice(device_ids, count, parallelism, results, sony_odStartSession);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odEndSessions(const char* const* device_ids, int32_t count,
+                                                 int32_t parallelism, OdResult* results) {
+  return ForEachDevice(device_ids, count, parallelism, results, sony_odEndSession);
+}
+
+// Parses the decimal number of a scent. Returns false if the name is not a number.
+static bool ParseScentName(const char* device_id, const char* scent_name, int32_t& scent) {
+  if (scent_name != nullptr) {
+    const char* end = scent_name + std::strlen(scent_name);
+    auto [ptr, ec] = std::from_chars(scent_name, end, scent);
+    if (ec == std::errc() && ptr == end && ptr != scent_name) {
+      return true;
     }
+  }
+  spdlog::error("{}: Invalid scent name: {}", device_id, scent_name ? scent_name : "(null)");
+  return false;
+}
 
-    if (scent1 == 3) {
-      if (now < it->second.scent3.cooldown_end_time) {
-        flag_scent3 = false;
-      } else {
-        flag_scent3 = true;
-      }
+OLFACTORY_DEVICE_API OdResult sony_odStartScentEmission(const char* device_id, const char* scent_name, float duration, bool& is_available) {
+  int32_t handle = 0;
+  int32_t scent = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS ||
+      !ParseScentName(device_id, scent_name, scent)) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odStartScentEmissionByHandle(handle, scent, duration, is_available);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odScheduleScentEmission(const char* device_id, const char* scent_name,
+                                                           float duration, int64_t time_us,
+                                                           bool& is_available) {
+  int32_t handle = 0;
+  int32_t scent = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS ||
+      !ParseScentName(device_id, scent_name, scent)) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odScheduleScentEmissionByHandle(handle, scent, duration, time_us, is_available);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odStopScentEmission(const char* device_id) {
+  int32_t handle = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odStopScentEmissionByHandle(handle);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odIsScentEmissionAvailable(const char* device_id, bool& is_available) {
+  int32_t handle = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odIsScentEmissionAvailableByHandle(handle, is_available);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odWaitScentEmissionAvailable(const char* device_id, int32_t timeout_ms,
+                                                                bool& is_available) {
+  int32_t handle = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odWaitScentEmissionAvailableByHandle(handle, timeout_ms, is_available);
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odGetScentEmissionTimes(const char* device_id, OdScentTime* times,
+                                                           int32_t capacity, int32_t& count) {
+  int32_t handle = 0;
+  if (sony_odGetDeviceHandle(device_id, handle) != OdResult::SUCCESS) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return sony_odGetScentEmissionTimesByHandle(handle, times, capacity, count);
+}
+
+// Timeline opened by sony_odOpenTimeline
+struct Timeline {
+  std::vector<int32_t> handles;           // Handle of each device id of the file, -1 if unknown
+  std::unique_ptr<TimelinePlayer> player;  // Schedules the records
+};
+
+static std::mutex g_timelineMutex;
+static std::unordered_map<int32_t, std::unique_ptr<Timeline>> g_timelines;
+static int32_t g_nextTimeline = 1;
+
+// Schedules one record of a timeline, called by its player thread
+static void EmitTimelineRecord(const Timeline& timeline, const TimelineRecord& record, int64_t time_us) {
+  if (record.device >= timeline.handles.size() || timeline.handles[record.device] < 0) {
+    return;
+  }
+  bool is_available = false;
+  int32_t handle = timeline.handles[record.device];
+  if (sony_odScheduleScentEmissionByHandle(handle, record.scent, record.duration, time_us, is_available) !=
+      OdResult::SUCCESS) {
+    spdlog::warn("{}: {} : Failed to schedule the record at {} us.", handle, __func__, record.time_us);
+  } else if (!is_available) {
+    spdlog::debug("{}: {} : Scent {} is unavailable at {} us.", handle, __func__, record.scent,
+                  record.time_us);
+  }
+}
+
+// Returns the player of a timeline, nullptr if it is not open. g_timelineMutex must be locked.
+static TimelinePlayer* FindTimeline(int32_t timeline, const char* caller) {
+  auto it = g_timelines.find(timeline);
+  if (it == g_timelines.end()) {
+    spdlog::error("{}: {} : Invalid timeline.", timeline, caller);
+    return nullptr;
+  }
+  return it->second->player.get();
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odWriteTimeline(const char* path, const OdTimelineEvent* events,
+                                                   int32_t count) {
+  if (path == nullptr || count < 0 || (events == nullptr && count > 0)) {
+    spdlog::error("{}: Invalid arguments.", __func__);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  std::vector<TimelineEntry> entries;
+  entries.reserve(count);
+  for (int32_t i = 0; i < count; i++) {
+    const OdTimelineEvent& event = events[i];
+    if (event.device_id == nullptr) {
+      spdlog::error("{}: Event {} has no device id.", __func__, i);
+      return OdResult::ERROR_UNKNOWN;
     }
+    entries.push_back({event.time_us, event.device_id, event.scent, event.duration});
+  }
+  if (!TimelineFile::Write(path, entries)) {
+    spdlog::error("{}: Failed to write {}.", __func__, path);
+    return OdResult::ERROR_UNKNOWN;
+  }
+  return OdResult::SUCCESS;
+}
 
-    if (flag_scent0 == true && flag_scent1 == true && flag_scent2 == true && flag_scent3 == true) {
-      is_available = true;
-    } else {
-      is_available = false;
+OLFACTORY_DEVICE_API OdResult sony_odOpenTimeline(const char* path, int32_t& timeline) {
+  auto entry = std::make_unique<Timeline>();
+  Timeline* opened = entry.get();
+  entry->player = std::make_unique<TimelinePlayer>([opened](const TimelineRecord& record, int64_t time_us) {
+    EmitTimelineRecord(*opened, record, time_us);
+  });
+  if (!entry->player->Open(path)) {
+    spdlog::error("{}: Failed to open {}.", __func__, path ? path : "(null)");
+    return OdResult::ERROR_UNKNOWN;
+  }
+
+  // Resolve the devices once, the records of an unknown device are skipped
+  for (const std::string& id : entry->player->File().Devices()) {
+    int32_t handle = -1;
+    if (!DeviceHandleTable::GetInstance().Resolve(id.c_str(), handle)) {
+      spdlog::warn("{}: {} : Device is not found in device.json, its records are skipped.", id, __func__);
+      handle = -1;
     }
+    entry->handles.push_back(handle);
+  }
+
+  std::lock_guard<std::mutex> lock(g_timelineMutex);
+  timeline = g_nextTimeline++;
+  g_timelines.emplace(timeline, std::move(entry));
+  return OdResult::SUCCESS;
+}
 
+OLFACTORY_DEVICE_API OdResult sony_odPlayTimeline(int32_t timeline) {
+  std::lock_guard<std::mutex> lock(g_timelineMutex);
+  TimelinePlayer* player = FindTimeline(timeline, __func__);
+  if (player == nullptr) {
+    return OdResult::ERROR_UNKNOWN;
   }
+  player->Play();
+  return OdResult::SUCCESS;
+}
 
-  // Check if scent emission is available
-//  is_available = device_sessions[ip]->IsScentEmissionAvailable();
+OLFACTORY_DEVICE_API OdResult sony_odPauseTimeline(int32_t timeline) {
+  std::lock_guard<std::mutex> lock(g_timelineMutex);
+  TimelinePlayer* player = FindTimeline(timeline, __func__);
+  if (player == nullptr) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  player->Pause();
+  return OdResult::SUCCESS;
+}
 
-//  spdlog::debug("{}({}): {} completed.", id, ip, __func__);
+OLFACTORY_DEVICE_API OdResult sony_odSeekTimeline(int32_t timeline, int64_t position_us) {
+  std::lock_guard<std::mutex> lock(g_timelineMutex);
+  TimelinePlayer* player = FindTimeline(timeline, __func__);
+  if (player == nullptr) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  player->Seek(position_us);
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odGetTimelinePosition(int32_t timeline, int64_t& position_us,
+                                                         bool& is_playing) {
+  std::lock_guard<std::mutex> lock(g_timelineMutex);
+  TimelinePlayer* player = FindTimeline(timeline, __func__);
+  if (player == nullptr) {
+    return OdResult::ERROR_UNKNOWN;
+  }
+  player->Position(position_us, is_playing);
+  return OdResult::SUCCESS;
+}
+
+OLFACTORY_DEVICE_API OdResult sony_odCloseTimeline(int32_t timeline) {
+  std::unique_ptr<Timeline> closed;
+  {
+    std::lock_guard<std::mutex> lock(g_timelineMutex);
+    auto it = g_timelines.find(timeline);
+    if (it == g_timelines.end()) {
+      spdlog::error("{}: {} : Invalid timeline.", timeline, __func__);
+      return OdResult::ERROR_UNKNOWN;
+    }
+    closed = std::move(it->second);
+    g_timelines.erase(it);
+  }
+  // The player thread is joined without the lock, the other timelines go on
+  closed.reset();
   return OdResult::SUCCESS;
 }
 
@@ -0,0 +1,88 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "osc_bundle.h"
+
+#include <cstring>
+
+#include "osc/OscOutboundPacketStream.h"
+
+namespace sony::olfactory_device {
+
+// Size taken by a "/scent" message in a bundle, including the element size field
+static size_t BundleElementSize(const DeviceCommand& command) {
+  // OSC strings are null terminated and padded to a multiple of 4 bytes
+  auto padded_size = [](size_t length) { return (length + 4) & ~static_cast<size_t>(3); };
+  return 4 + padded_size(strlen("/scent")) + padded_size(strlen(",sii")) +
+         padded_size(strlen(GetCommandName(command.opcode))) + 4 + 4;
+}
+
+#define OSC_NTP_UNIX_OFFSET (2208988800ULL)  // Seconds from 1900 (NTP epoch) to 1970 (Unix epoch)
+
+uint64_t ToOscTimeTag(std::chrono::steady_clock::time_point time) {
+  auto offset = time - std::chrono::steady_clock::now();
+  auto system_time =
+      std::chrono::system_clock::now() + std::chrono::duration_cast<std::chrono::system_clock::duration>(offset);
+  uint64_t nanoseconds = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(system_time.time_since_epoch()).count());
+  uint64_t seconds = nanoseconds / 1000000000ULL + OSC_NTP_UNIX_OFFSET;
+  uint64_t fraction = ((nanoseconds % 1000000000ULL) << 32) / 1000000000ULL;
+  return (seconds << 32) | fraction;
+}
+
+void EncodeOscBundles(const std::vector<DeviceCommand>& commands,
+                      const std::function<void(const char* data, size_t size)>& emit, uint64_t time_tag) {
+  // Bundle header: "#bundle" and the time tag
+  const size_t bundle_header_size = 16;
+
+  // Extra room for the type tags which oscpack builds at the end of the buffer
+  char buffer[OSC_MAX_PACKET_SIZE + 64] = {0};
+  osc::OutboundPacketStream p(buffer, sizeof(buffer));
+
+  size_t messages = 0;
+  size_t packet_size = bundle_header_size;
+
+  for (const auto& command : commands) {
+    // Emit the current bundle when this message would exceed one datagram
+    size_t element_size = BundleElementSize(command);
+    if (messages > 0 && packet_size + element_size > OSC_MAX_PACKET_SIZE) {
+      p << osc::EndBundle;
+      emit(p.Data(), p.Size());
+      p.Clear();
+      messages = 0;
+      packet_size = bundle_header_size;
+    }
+    if (messages == 0) {
+      p << osc::BeginBundle(time_tag);
+    }
+
+    const char* name = GetCommandName(command.opcode);
+    p << osc::BeginMessage("/scent") << name << command.target << command.level << osc::EndMessage;
+    messages++;
+    packet_size += element_size;
+  }
+
+  if (messages > 0) {
+    p << osc::EndBundle;
+    emit(p.Data(), p.Size());
+  }
+}
+
+}  // namespace sony::olfactory_device
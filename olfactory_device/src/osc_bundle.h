@@ -0,0 +1,61 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "device_command.h"
+
+#include <chrono>
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#define OSC_PORT (7000)
+#define OSC_MAX_PACKET_SIZE (1472)  // Ethernet MTU (1500) - IPv4 header (20) - UDP header (8)
+#define OSC_TIMETAG_IMMEDIATE (1)   // Time tag of a bundle executed as soon as it is received
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief Converts a time of the steady clock to an OSC time tag.
+ *
+ * OSC time tags are NTP timestamps: seconds since 1900 in the upper 32 bits and the fraction of a second
+ * in the lower 32 bits. The time is mapped to the wall clock, which the devices synchronize with NTP.
+ *
+ * @param time The time to convert.
+ * @return Returns the time tag.
+ */
+uint64_t ToOscTimeTag(std::chrono::steady_clock::time_point time);
+
+/**
+ * @brief Encodes commands into OSC bundles of up to OSC_MAX_PACKET_SIZE bytes each.
+ *
+ * Each command becomes a "/scent" message. A new bundle is started only when the next message would
+ * not fit in the current one.
+ *
+ * @param commands The commands to encode, in order.
+ * @param emit Called with each complete bundle. The data is only valid during the call.
+ * @param time_tag The time tag of the bundles, see ToOscTimeTag().
+ */
+void EncodeOscBundles(const std::vector<DeviceCommand>& commands,
+                      const std::function<void(const char* data, size_t size)>& emit,
+                      uint64_t time_tag = OSC_TIMETAG_IMMEDIATE);
+
+}  // namespace sony::olfactory_device
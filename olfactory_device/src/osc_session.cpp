@@ -19,11 +19,14 @@
  */
 
 #include "osc_session.h"
+#include "async_log.h"
+#include "udp_transmit_batch.h"
 
+#include <cstring>
 #include <iostream>
 #include <iomanip> // for std::setw, std::setfill
+#include <string>
 #include <vector>
-#include <sstream>
 
 // Uncomment to be enabled Thread
 //#define ENABLED_THREAD
@@ -47,12 +50,23 @@ OscSession::~OscSession() {
 bool OscSession::Open(const char* device_id) {
   std::cout << "[OscSession] device_id: " << device_id << std::endl;
   osc_ip_ = device_id;
+
+  // Create the transmit socket once and reuse it for all commands of this session
+  try {
+    endpoint_ = IpEndpointName(osc_ip_.c_str(), osc_port_);
+    transmit_socket_ = std::make_unique<UdpTransmitSocket>(endpoint_);
+  } catch (const std::exception& e) {
+    std::cerr << "[OscSession] Failed to open UDP socket for: " << osc_ip_ << " (" << e.what() << ")" << std::endl;
+    return false;
+  }
+
   connected_ = true;
   return true;
 }
 
 void OscSession::Close() {
   if (connected_) {
+    transmit_socket_.reset();
     connected_ = false;
     std::cout << "[OscSession] OSC connection closed." << std::endl;
   }
@@ -62,39 +76,75 @@ bool OscSession::IsConnected() const {
   return connected_;
 }
 
-bool OscSession::SendData(const std::string& data) {
+bool OscSession::Transmit(const char* data, size_t size) {
+  UdpTransmitBatch* batch = UdpTransmitBatch::Current();
+  if (batch != nullptr) {
+    batch->Add(endpoint_, data, size);
+    return true;
+  }
+
+  try {
+    transmit_socket_->Send(data, size);
+  } catch (const std::exception& e) {
+    std::cerr << "[OscSession] Failed to send to: " << osc_ip_ << " (" << e.what() << ")" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool OscSession::SendBundles(const std::vector<DeviceCommand>& commands, uint64_t time_tag) {
+  bool sent = true;
+  try {
+    EncodeOscBundles(
+        commands, [this, &sent](const char* data, size_t size) { sent = Transmit(data, size) && sent; },
+        time_tag);
+  } catch (const std::exception& e) {
+    std::cerr << "[OscSession] Failed to encode OSC bundle for: " << osc_ip_ << " (" << e.what() << ")"
+              << std::endl;
+    return false;
+  }
+  return sent;
+}
+
+bool OscSession::SendData(const DeviceCommand& command) {
+  // A bundle of one message, encoded like the batches
+  return SendDataBatch({command});
+}
+
+bool OscSession::SendDataBatch(const std::vector<DeviceCommand>& commands) {
   if (!connected_) {
     std::cerr << "[OscSession] OSC not connected." << std::endl;
     return false;
   }
 
   // Write data to OSC (platform-dependent)
-  UdpTransmitSocket transmitSocket(IpEndpointName(osc_ip_.c_str(), OSC_PORT));
-
-  char buffer[1024] = {0};
-  osc::OutboundPacketStream p(buffer, sizeof(buffer) - 1);
-
-//  p << osc::BeginBundleImmediate << osc::BeginMessage("/scent") << data.c_str() << osc::EndMessage << osc::EndBundle;
-  size_t start = data.find('(');
-  size_t end = data.find(')');
-  std::string command = data.substr(0, start);
-  std::string arguments = data.substr(start + 1, end - start - 1);
-  std::istringstream iss(arguments);
-  std::string arg;
-  std::vector<std::string> args;
-  while (std::getline(iss, arg, ',')) {
-    args.push_back(arg);
+  if (!SendBundles(commands, OSC_TIMETAG_IMMEDIATE)) {
+    return false;
   }
-  int target = std::stoi(args[0]);
-  int level = std::stoi(args[1]);
 
-  p << osc::BeginBundleImmediate << osc::BeginMessage("/scent") << command.c_str() << target << level << osc::EndMessage << osc::EndBundle;
-  transmitSocket.Send(p.Data(), p.Size());
+  for (const auto& command : commands) {
+    ConsoleLog(FOREGROUND_GREEN | FOREGROUND_INTENSITY, "[OscSession] Data send: ({}){}/{}/{}", osc_ip_,
+               GetCommandName(command.opcode), command.target, command.level);
+  }
+  return true;
+}
 
-  HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-  SetConsoleTextAttribute(hConsole, FOREGROUND_GREEN | FOREGROUND_INTENSITY);
-  std::cout << "[OscSession] Data send: (" << osc_ip_ << ")" << command << "/" << target << "/" << level << std::endl;
-  SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
+bool OscSession::SendDataAt(const std::vector<DeviceCommand>& commands,
+                            std::chrono::steady_clock::time_point time) {
+  if (!connected_) {
+    std::cerr << "[OscSession] OSC not connected." << std::endl;
+    return false;
+  }
+
+  // Write data to OSC (platform-dependent)
+  if (!SendBundles(commands, ToOscTimeTag(time))) {
+    return false;
+  }
+
+  for (const auto& command : commands) {
+    ConsoleLog(FOREGROUND_GREEN | FOREGROUND_INTENSITY, "[OscSession] Data send: ({}){}/{}/{} (time-tagged)",
+               osc_ip_, GetCommandName(command.opcode), command.target, command.level);
+  }
   return true;
 }
 
@@ -20,10 +20,11 @@
 
 #pragma once
 #include "device_session_if.h"
+#include "osc_bundle.h"
 #include <string>
-#include <windows.h>
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <queue>
 
 #include <iostream>
@@ -31,7 +32,6 @@
 #include "ip/UdpSocket.h"
 
 #define THREAD_WAIT (200)
-#define OSC_PORT (7000)
 
 namespace sony::olfactory_device {
 
@@ -46,6 +46,15 @@ class OscSession : public DeviceSessionIF {
   std::string       osc_ip_;      // OSC IP address
   int               osc_port_;    // OSC port
   bool connected_;        // Connection status
+  IpEndpointName    endpoint_;   // OSC device address, resolved by Open()
+  std::unique_ptr<UdpTransmitSocket> transmit_socket_;  // Socket reused for every send until Close()
+
+  // Sends a packet, or adds it to the UdpTransmitBatch installed on the calling thread.
+  // Returns false if the packet could not be sent.
+  bool Transmit(const char* data, size_t size);
+
+  // Encodes the commands into bundles and transmits them. Returns false if any bundle was not sent.
+  bool SendBundles(const std::vector<DeviceCommand>& commands, uint64_t time_tag);
 
  public:
   OscSession();
@@ -54,6 +63,10 @@ class OscSession : public DeviceSessionIF {
   /**
    * @brief Opens a OSC session with the specified device.
    *
+   * The UDP socket used to transmit to the device is created here and kept until Close().
+   * While a UdpTransmitBatch is installed on the calling thread, the packets of SendData() and
+   * SendDataBatch() are added to that batch and sent by its Flush() instead.
+   *
    * @param device_id The identifier of the OSC device (e.g., IP, port name).
    * @return Returns true if the connection was successfully established, false otherwise.
    */
@@ -72,12 +85,43 @@ class OscSession : public DeviceSessionIF {
   bool IsConnected() const override;
 
   /**
-   * @brief Sends data over the OSC connection.
+   * @brief Sends a command over the OSC connection.
    *
-   * @param data The data to send over the OSC.
+   * @param command The command to send over the OSC.
    * @return Returns true if the data was successfully sent, false otherwise.
    */
-  bool SendData(const std::string& data) override;
+  bool SendData(const DeviceCommand& command) override;
+
+  /**
+   * @brief Sends several commands in a single OSC bundle.
+   *
+   * The commands are packed into one bundle and sent as one UDP datagram. A new bundle is started only
+   * when the next command would not fit in OSC_MAX_PACKET_SIZE.
+   *
+   * @param commands The commands to send, in order.
+   * @return Returns true if all the commands were successfully sent, false otherwise.
+   */
+  bool SendDataBatch(const std::vector<DeviceCommand>& commands) override;
+
+  /**
+   * @brief Checks if the session can send commands executed at a given time.
+   *
+   * @return Returns true, the bundles carry the execution time as their OSC time tag.
+   */
+  bool SupportsTimeTags() const override { return true; }
+
+  /**
+   * @brief Sends several commands in OSC bundles time-tagged with their execution time.
+   *
+   * Devices which honor the time tags execute the commands at the given time. Other devices execute them
+   * when they are received.
+   *
+   * @param commands The commands to send, in order.
+   * @param time The time at which the device executes the commands.
+   * @return Returns true if all the commands were successfully sent, false otherwise.
+   */
+  bool SendDataAt(const std::vector<DeviceCommand>& commands,
+                  std::chrono::steady_clock::time_point time) override;
 
   /**
    * @brief Received data over the OSC connection.
@@ -0,0 +1,62 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief Calls a function for each index in [0, count) from up to parallelism threads.
+ *
+ * The calling thread takes part in the work, so at most parallelism - 1 threads are started. The
+ * indexes are handed out one at a time, so slow calls (e.g. opening a device) do not hold back the
+ * others. Returns once all the calls have completed.
+ *
+ * @param count The number of indexes.
+ * @param parallelism The maximum number of concurrent calls, 1 or less runs all the calls in order.
+ * @param function The function called with each index.
+ */
+template <typename Function>
+void ParallelFor(int32_t count, int32_t parallelism, const Function& function) {
+  std::atomic<int32_t> next(0);
+  auto worker = [&next, count, &function]() {
+    for (int32_t index = next++; index < count; index = next++) {
+      function(index);
+    }
+  };
+
+  int32_t threads = std::min(std::max(parallelism, 1), count) - 1;
+  std::vector<std::thread> workers;
+  workers.reserve(std::max(threads, 0));
+  for (int32_t i = 0; i < threads; i++) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : workers) {
+    thread.join();
+  }
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,61 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "serial_port.h"
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace sony::olfactory_device {
+
+int OpenSerialPort(const char* path, bool non_blocking) {
+  int fd = open(path, O_RDWR | O_NOCTTY | O_CLOEXEC | (non_blocking ? O_NONBLOCK : 0));
+  if (fd < 0) {
+    std::cerr << "[SerialPort] Failed to open serial port: " << path << " (" << strerror(errno) << ")"
+              << std::endl;
+    return -1;
+  }
+
+  termios tty = {};
+  if (tcgetattr(fd, &tty) != 0) {
+    std::cerr << "[SerialPort] Error getting serial port state for: " << path << std::endl;
+    close(fd);
+    return -1;
+  }
+  cfmakeraw(&tty);
+  cfsetispeed(&tty, B115200);  // Fixed baud rate to 115200
+  cfsetospeed(&tty, B115200);
+  tty.c_cflag |= CLOCAL | CREAD;
+  tty.c_cflag &= ~(CSTOPB | PARENB);  // One stop bit, no parity
+  if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+    std::cerr << "[SerialPort] Error setting serial port state for: " << path << std::endl;
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
@@ -0,0 +1,64 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "session_table.h"
+
+#include <functional>
+
+namespace sony::olfactory_device {
+
+SessionTable& SessionTable::GetInstance() {
+  static SessionTable instance;
+  return instance;
+}
+
+SessionTable::Shard& SessionTable::GetShard(const std::string& address) {
+  return shards_[std::hash<std::string>{}(address) % SESSION_TABLE_SHARDS];
+}
+
+std::shared_ptr<DeviceSlot> SessionTable::Find(const std::string& address) {
+  Shard& shard = GetShard(address);
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
+  auto it = shard.slots.find(address);
+  if (it == shard.slots.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+std::shared_ptr<DeviceSlot> SessionTable::FindOrCreate(const std::string& address) {
+  Shard& shard = GetShard(address);
+  {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.slots.find(address);
+    if (it != shard.slots.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
+  auto& slot = shard.slots[address];
+  if (!slot) {
+    slot = std::make_shared<DeviceSlot>();
+  }
+  return slot;
+}
+
+}  // namespace sony::olfactory_device
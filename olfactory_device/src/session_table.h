@@ -0,0 +1,127 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "device_session_if.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define SESSION_TABLE_SHARDS (32)  // Number of shards of the session table
+
+namespace sony::olfactory_device {
+
+// Struct to store emission and cooldown end times
+struct DeviceScent {
+  std::chrono::steady_clock::time_point emission_end_time;  // End of emission
+  std::chrono::steady_clock::time_point cooldown_end_time;  // End of cooldown
+  float duration = 0.0f;                                    // Duration for the current emission
+  uint64_t emission_timer = 0;                              // Timer of the end of the emission, 0 if none
+  uint64_t cooldown_timer = 0;                              // Timer of the end of the cooldown, 0 if none
+};
+
+/**
+ * @brief DeviceTimes holds the emission and cooldown times of each channel of a device.
+ *
+ * The channels are indexed by their number. The table grows up to the highest channel emitted so far;
+ * a channel which is not in the table has never emitted and is available.
+ */
+struct DeviceTimes {
+  std::vector<DeviceScent> channels;  // Times indexed by the channel number
+
+  // Returns the times of a channel, or nullptr if the channel has never emitted
+  const DeviceScent* Find(int32_t channel) const {
+    if (channel < 0 || channel >= static_cast<int32_t>(channels.size())) {
+      return nullptr;
+    }
+    return &channels[channel];
+  }
+
+  // Returns the times of a channel, adding it to the table if needed
+  DeviceScent& At(int32_t channel) {
+    if (channel >= static_cast<int32_t>(channels.size())) {
+      channels.resize(channel + 1);
+    }
+    return channels[channel];
+  }
+};
+
+/**
+ * @brief DeviceSlot holds the session and the emission timing of one device.
+ *
+ * All accesses to the members must be done while holding mutex.
+ */
+struct DeviceSlot {
+  std::mutex mutex;                          // Serializes the operations on this device
+  std::unique_ptr<DeviceSessionIF> session;  // Session to the device, nullptr if not started
+  DeviceTimes times;                         // Emission and cooldown times of the device
+  std::condition_variable available;         // Notified when a cooldown ends or the session ends
+  uint64_t generation = 0;                   // Incremented when the scheduled commands are dropped
+};
+
+/**
+ * @brief SessionTable manages the device slots by address, for concurrent callers.
+ *
+ * The table is split into shards by the hash of the address. A shard lock is only held while looking
+ * up or adding a slot, and lookups share the lock, so calls for different devices never wait for each
+ * other. Operations on a device are serialized by the mutex of its DeviceSlot. A slot lives as long as
+ * the process, so that it can be referenced by device handles; ending a session only resets it.
+ */
+class SessionTable {
+ private:
+  struct Shard {
+    std::shared_mutex mutex;                                            // Protects slots
+    std::unordered_map<std::string, std::shared_ptr<DeviceSlot>> slots;  // Slots indexed by address
+  };
+  std::array<Shard, SESSION_TABLE_SHARDS> shards_;
+
+  Shard& GetShard(const std::string& address);
+
+ public:
+  /**
+   * @brief Returns the process-wide session table.
+   */
+  static SessionTable& GetInstance();
+
+  /**
+   * @brief Looks up the slot of a device.
+   *
+   * @param address The address of the device (IP address or COM port).
+   * @return Returns the slot, or nullptr if the device has no slot.
+   */
+  std::shared_ptr<DeviceSlot> Find(const std::string& address);
+
+  /**
+   * @brief Looks up the slot of a device, adding an empty slot if the device has none.
+   *
+   * @param address The address of the device (IP address or COM port).
+   * @return Returns the slot of the device.
+   */
+  std::shared_ptr<DeviceSlot> FindOrCreate(const std::string& address);
+};
+
+}  // namespace sony::olfactory_device
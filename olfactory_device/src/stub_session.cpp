@@ -63,19 +63,20 @@ bool StubSession::IsConnected() const {
   return connected_;
 }
 
-bool StubSession::SendData(const std::string& data) {
+bool StubSession::SendData(const DeviceCommand& command) {
   if (!connected_) {
     spdlog::error("[StubSession] Error: Cannot send data, not connected to any device.");
     return false;
   }
 
   // Log the data being sent and simulate the sending operation
-  spdlog::debug("[StubSession] Data sent: no data because of a simulate: {}", data);
+  spdlog::debug("[StubSession] Data sent: no data because of a simulate: {}({},{})",
+                GetCommandName(command.opcode), command.target, command.level);
 
   return true;  // Simulate successful data transmission
 }
 
-bool StubSession::RecvData(std::string& data) {
+bool StubSession::RecvData(std::string& /*data*/) {
   if (!connected_) {
     spdlog::error("[StubSession] Error: Cannot receive data, not connected to any device.");
     return false;
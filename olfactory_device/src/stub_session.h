@@ -22,7 +22,6 @@
 
 #include "device_session_if.h"
 #include <string>
-#include <windows.h>
 #include <thread>
 #include <atomic>
 #include <queue>
@@ -64,12 +63,12 @@ class StubSession : public DeviceSessionIF {
   bool IsConnected() const override;
 
   /**
-   * @brief Simulates sending data over the session.
+   * @brief Simulates sending a command over the session.
    *
-   * @param data The data that would be sent over the session.
+   * @param command The command that would be sent over the session.
    * @return Always returns true to simulate successful data transmission.
    */
-  bool SendData(const std::string& data) override;
+  bool SendData(const DeviceCommand& command) override;
 
   /**
    * @brief Simulates received data over the session.
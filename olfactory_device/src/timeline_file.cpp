@@ -0,0 +1,265 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "timeline_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sony::olfactory_device {
+
+TimelineFile::TimelineFile()
+    : data_(nullptr),
+      size_(0),
+      records_(nullptr),
+      index_(nullptr),
+      count_(0),
+      index_count_(0)
+#ifdef _WIN32
+      ,
+      file_(INVALID_HANDLE_VALUE),
+      mapping_(nullptr)
+#endif
+{
+}
+
+TimelineFile::~TimelineFile() {
+  Close();
+}
+
+#ifdef _WIN32
+bool TimelineFile::Map(const char* path) {
+  file_ = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+    Unmap();
+    return false;
+  }
+  mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ == nullptr) {
+    Unmap();
+    return false;
+  }
+  data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == nullptr) {
+    Unmap();
+    return false;
+  }
+  size_ = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+void TimelineFile::Unmap() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+  }
+  if (file_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(file_);
+  }
+  data_ = nullptr;
+  mapping_ = nullptr;
+  file_ = INVALID_HANDLE_VALUE;
+}
+#else
+bool TimelineFile::Map(const char* path) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  // The mapping keeps the file alive, the descriptor is not needed anymore
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  // The records are read in order, let the kernel read ahead
+  madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(data);
+  size_ = static_cast<size_t>(st.st_size);
+  return true;
+}
+
+void TimelineFile::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+}
+#endif
+
+bool TimelineFile::Open(const char* path) {
+  Close();
+  if (path == nullptr || !Map(path)) {
+    std::cerr << "[TimelineFile] Failed to map: " << (path ? path : "(null)") << std::endl;
+    return false;
+  }
+
+  // Check that every section lies within the file before reading it
+  TimelineHeader header;
+  bool valid = size_ >= sizeof(header);
+  if (valid) {
+    memcpy(&header, data_, sizeof(header));
+    valid = memcmp(header.magic, TIMELINE_MAGIC, sizeof(header.magic)) == 0 &&
+            header.version == TIMELINE_VERSION;
+  }
+  valid = valid && header.events_offset % alignof(TimelineRecord) == 0 && header.events_offset <= size_ &&
+          header.event_count <= (size_ - header.events_offset) / sizeof(TimelineRecord);
+  valid = valid && header.index_offset % alignof(uint64_t) == 0 && header.index_offset <= size_ &&
+          header.index_count <= (size_ - header.index_offset) / sizeof(uint64_t);
+  valid = valid && header.devices_offset <= size_;
+  if (!valid) {
+    std::cerr << "[TimelineFile] Not a valid timeline: " << path << std::endl;
+    Close();
+    return false;
+  }
+
+  const char* device = data_ + header.devices_offset;
+  const char* end = data_ + size_;
+  for (uint32_t i = 0; i < header.device_count; i++) {
+    const char* terminator = static_cast<const char*>(memchr(device, '\0', end - device));
+    if (terminator == nullptr) {
+      std::cerr << "[TimelineFile] Truncated device ids: " << path << std::endl;
+      Close();
+      return false;
+    }
+    devices_.emplace_back(device, terminator);
+    device = terminator + 1;
+  }
+
+  records_ = reinterpret_cast<const TimelineRecord*>(data_ + header.events_offset);
+  index_ = reinterpret_cast<const uint64_t*>(data_ + header.index_offset);
+  count_ = header.event_count;
+  index_count_ = header.index_count;
+  return true;
+}
+
+void TimelineFile::Close() {
+  Unmap();
+  size_ = 0;
+  records_ = nullptr;
+  index_ = nullptr;
+  count_ = 0;
+  index_count_ = 0;
+  devices_.clear();
+}
+
+int64_t TimelineFile::Duration() const {
+  return count_ == 0 ? 0 : records_[count_ - 1].time_us;
+}
+
+uint64_t TimelineFile::Seek(int64_t time_us) const {
+  if (time_us <= 0) {
+    return 0;
+  }
+  uint64_t entry = static_cast<uint64_t>(time_us / TIMELINE_INDEX_INTERVAL_US);
+  if (entry >= index_count_) {
+    return count_;
+  }
+  // The index gives the start of the interval, the rest is within one interval
+  uint64_t index = std::min(index_[entry], count_);
+  while (index < count_ && records_[index].time_us < time_us) {
+    index++;
+  }
+  return index;
+}
+
+bool TimelineFile::Write(const char* path, const std::vector<TimelineEntry>& entries) {
+  // Give each device id its number, in order of appearance
+  std::unordered_map<std::string, uint32_t> numbers;
+  std::vector<const std::string*> devices;
+  std::vector<TimelineRecord> records;
+  records.reserve(entries.size());
+  for (const TimelineEntry& entry : entries) {
+    if (entry.time_us < 0) {
+      std::cerr << "[TimelineFile] Negative time: " << entry.time_us << std::endl;
+      return false;
+    }
+    auto number = numbers.emplace(entry.device_id, static_cast<uint32_t>(devices.size()));
+    if (number.second) {
+      devices.push_back(&number.first->first);
+    }
+    records.push_back({entry.time_us, number.first->second, entry.scent, entry.duration, 0});
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const TimelineRecord& a, const TimelineRecord& b) { return a.time_us < b.time_us; });
+
+  // Entry i of the index is the first record at or after i intervals
+  uint64_t index_count = records.empty() ? 0 : records.back().time_us / TIMELINE_INDEX_INTERVAL_US + 1;
+  std::vector<uint64_t> index(index_count);
+  uint64_t position = 0;
+  for (uint64_t i = 0; i < index_count; i++) {
+    int64_t time_us = static_cast<int64_t>(i) * TIMELINE_INDEX_INTERVAL_US;
+    while (position < records.size() && records[position].time_us < time_us) {
+      position++;
+    }
+    index[i] = position;
+  }
+
+  TimelineHeader header = {};
+  memcpy(header.magic, TIMELINE_MAGIC, sizeof(header.magic));
+  header.version = TIMELINE_VERSION;
+  header.event_count = records.size();
+  header.events_offset = sizeof(header);
+  header.index_count = index_count;
+  header.index_offset = header.events_offset + records.size() * sizeof(TimelineRecord);
+  header.device_count = static_cast<uint32_t>(devices.size());
+  header.devices_offset = header.index_offset + index_count * sizeof(uint64_t);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TimelineRecord));
+  file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(uint64_t));
+  for (const std::string* device : devices) {
+    file.write(device->c_str(), device->size() + 1);
+  }
+  file.close();
+  if (!file) {
+    std::cerr << "[TimelineFile] Failed to write: " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,147 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define TIMELINE_MAGIC ("ODTL")                  // First bytes of a timeline file
+#define TIMELINE_VERSION (1)                     // Version of the layout below
+#define TIMELINE_INDEX_INTERVAL_US (1000000LL)   // Time between two entries of the time index
+
+namespace sony::olfactory_device {
+
+/** Header at the start of a timeline file. The offsets are from the start of the file. */
+struct TimelineHeader {
+  char magic[4];            // TIMELINE_MAGIC
+  uint32_t version;         // TIMELINE_VERSION
+  uint64_t event_count;     // Number of TimelineRecord
+  uint64_t events_offset;   // Records sorted by time
+  uint64_t index_count;     // Number of index entries
+  uint64_t index_offset;    // Entry i is the first record at or after i * TIMELINE_INDEX_INTERVAL_US
+  uint32_t device_count;    // Number of device ids
+  uint32_t reserved;        // 0
+  uint64_t devices_offset;  // Device ids, each terminated by a null character, up to the end of the file
+};
+
+/** One emission of a timeline file */
+struct TimelineRecord {
+  int64_t time_us;    // Time of the emission from the start of the timeline
+  uint32_t device;    // Index of the device id
+  int32_t scent;      // Number of the scent
+  float duration;     // Duration of the emission in seconds
+  uint32_t reserved;  // 0
+};
+
+/** One emission to write with TimelineFile::Write() */
+struct TimelineEntry {
+  int64_t time_us;        // Time of the emission from the start of the timeline
+  std::string device_id;  // Id of the device, as written in device.json
+  int32_t scent;          // Number of the scent
+  float duration;         // Duration of the emission in seconds
+};
+
+/**
+ * @brief TimelineFile gives access to a timeline file mapped in memory.
+ *
+ * The file is mapped read-only and never copied: the records are read in place, so the pages of a long
+ * show are loaded by the OS as the playback reaches them and can be dropped again under memory
+ * pressure. Only the device ids are copied at Open(). Seek() finds a time through the time index and
+ * touches the records of one index interval at most. The records are in the byte order of the host.
+ */
+class TimelineFile {
+ private:
+  const char* data_;                     // Mapped file, nullptr if not open
+  size_t size_;                          // Size of the mapping
+  const TimelineRecord* records_;        // Records in data_
+  const uint64_t* index_;                // Time index in data_
+  uint64_t count_;                       // Number of records
+  uint64_t index_count_;                 // Number of index entries
+  std::vector<std::string> devices_;     // Device ids
+#ifdef _WIN32
+  void* file_;                           // File handle
+  void* mapping_;                        // File mapping handle
+#endif
+
+  bool Map(const char* path);
+  void Unmap();
+
+ public:
+  TimelineFile();
+  ~TimelineFile();
+
+  TimelineFile(const TimelineFile&) = delete;
+  TimelineFile& operator=(const TimelineFile&) = delete;
+
+  /**
+   * @brief Maps a timeline file and checks its layout.
+   *
+   * @param path The path of the file.
+   * @return Returns false if the file cannot be mapped or is not a valid timeline.
+   */
+  bool Open(const char* path);
+
+  /**
+   * @brief Unmaps the file.
+   */
+  void Close();
+
+  /**
+   * @brief Returns the number of records.
+   */
+  uint64_t Count() const { return count_; }
+
+  /**
+   * @brief Returns a record.
+   *
+   * @param index The index of the record, less than Count().
+   */
+  const TimelineRecord& Record(uint64_t index) const { return records_[index]; }
+
+  /**
+   * @brief Returns the device ids, indexed by TimelineRecord::device.
+   */
+  const std::vector<std::string>& Devices() const { return devices_; }
+
+  /**
+   * @brief Returns the time of the last record, 0 if the timeline is empty.
+   */
+  int64_t Duration() const;
+
+  /**
+   * @brief Returns the index of the first record at or after a time, Count() if there is none.
+   *
+   * @param time_us The time from the start of the timeline.
+   */
+  uint64_t Seek(int64_t time_us) const;
+
+  /**
+   * @brief Writes a timeline file. The entries are sorted by time, entries at the same time keep their order.
+   *
+   * @param path The path of the file.
+   * @param entries The emissions of the timeline.
+   * @return Returns false if a time is negative or the file cannot be written.
+   */
+  static bool Write(const char* path, const std::vector<TimelineEntry>& entries);
+};
+
+}  // namespace sony::olfactory_device
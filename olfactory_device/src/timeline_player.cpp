@@ -0,0 +1,143 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "timeline_player.h"
+
+#include <algorithm>
+
+namespace sony::olfactory_device {
+
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+TimelinePlayer::TimelinePlayer(EmitFunction emit)
+    : emit_(std::move(emit)), playing_(false), stop_(false), position_us_(0), next_(0) {
+  thread_ = std::thread(&TimelinePlayer::Run, this);
+}
+
+TimelinePlayer::~TimelinePlayer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+bool TimelinePlayer::Open(const char* path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  playing_ = false;
+  position_us_ = 0;
+  next_ = 0;
+  return file_.Open(path);
+}
+
+int64_t TimelinePlayer::PositionAt(steady_clock::time_point now) const {
+  if (!playing_) {
+    return position_us_;
+  }
+  return position_us_ + std::chrono::duration_cast<microseconds>(now - anchor_).count();
+}
+
+void TimelinePlayer::Play() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (playing_ || file_.Count() == 0) {
+      return;
+    }
+    if (next_ >= file_.Count()) {
+      position_us_ = 0;
+      next_ = 0;
+    }
+    anchor_ = steady_clock::now();
+    playing_ = true;
+  }
+  cv_.notify_all();
+}
+
+void TimelinePlayer::Pause() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  position_us_ = PositionAt(steady_clock::now());
+  playing_ = false;
+}
+
+void TimelinePlayer::Seek(int64_t position_us) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    position_us_ = std::max<int64_t>(position_us, 0);
+    anchor_ = steady_clock::now();
+    next_ = file_.Seek(position_us_);
+  }
+  cv_.notify_all();
+}
+
+void TimelinePlayer::Position(int64_t& position_us, bool& is_playing) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  position_us = PositionAt(steady_clock::now());
+  is_playing = playing_;
+}
+
+void TimelinePlayer::Run() {
+  std::vector<std::pair<TimelineRecord, int64_t>> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    if (!playing_) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    // Hand out everything due within the lookahead, with its absolute time
+    auto now = steady_clock::now();
+    int64_t horizon = PositionAt(now) + TIMELINE_LOOKAHEAD_MS * 1000;
+    int64_t origin =
+        std::chrono::duration_cast<microseconds>(anchor_.time_since_epoch()).count() - position_us_;
+    while (next_ < file_.Count() && file_.Record(next_).time_us < horizon) {
+      const TimelineRecord& record = file_.Record(next_);
+      batch.emplace_back(record, origin + record.time_us);
+      next_++;
+    }
+    if (!batch.empty()) {
+      // Emit without the lock, Pause() and Seek() only wait for the batch being taken
+      lock.unlock();
+      for (const auto& [record, time_us] : batch) {
+        emit_(record, time_us);
+      }
+      batch.clear();
+      lock.lock();
+      continue;
+    }
+
+    if (next_ >= file_.Count()) {
+      // Every record is handed out, the playback ends at the last one
+      int64_t end = file_.Duration();
+      if (PositionAt(now) >= end) {
+        position_us_ = std::max(end, position_us_);
+        playing_ = false;
+        continue;
+      }
+      cv_.wait_until(lock, now + microseconds(end - PositionAt(now)));
+    } else {
+      int64_t wait = file_.Record(next_).time_us - horizon;
+      cv_.wait_until(lock, now + microseconds(wait));
+    }
+  }
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,121 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "timeline_file.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#define TIMELINE_LOOKAHEAD_MS (50)  // Records handed to the scheduler this long before their time
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief TimelinePlayer plays the records of a TimelineFile on the clock of sony_odGetTime.
+ *
+ * The player thread does not send the emissions itself: it hands each record to the emit function
+ * TIMELINE_LOOKAHEAD_MS before its time, with the absolute time at which it must start, and the
+ * scheduling path (time tags or EmissionScheduler) sends it on time. The thread only wakes up once per
+ * batch of records, however long the timeline. Pause() and Seek() apply to the records not handed out
+ * yet, the ones within the lookahead are still emitted. Playback stops by itself at the last record.
+ */
+class TimelinePlayer {
+ public:
+  /** Emits a record at time_us, on the clock of sony_odGetTime */
+  using EmitFunction = std::function<void(const TimelineRecord& record, int64_t time_us)>;
+
+ private:
+  TimelineFile file_;                                // Mapped timeline
+  EmitFunction emit_;                                // Called by the player thread for each record
+
+  std::mutex mutex_;                                 // Protects the members below
+  std::condition_variable cv_;                       // Wakes the player thread
+  bool playing_;                                     // The position advances
+  bool stop_;                                        // The player thread must exit
+  int64_t position_us_;                              // Position at anchor_
+  std::chrono::steady_clock::time_point anchor_;     // Time of position_us_ while playing
+  uint64_t next_;                                    // Next record to hand out
+  std::thread thread_;                               // Player thread
+
+  void Run();
+  int64_t PositionAt(std::chrono::steady_clock::time_point now) const;
+
+ public:
+  /**
+   * @brief Starts the player thread, paused at the start of the timeline.
+   *
+   * @param emit Called by the player thread with each record.
+   */
+  explicit TimelinePlayer(EmitFunction emit);
+
+  /**
+   * @brief Stops the player thread and unmaps the timeline.
+   */
+  ~TimelinePlayer();
+
+  TimelinePlayer(const TimelinePlayer&) = delete;
+  TimelinePlayer& operator=(const TimelinePlayer&) = delete;
+
+  /**
+   * @brief Maps a timeline file, see TimelineFile::Open(). Must be called before Play().
+   *
+   * @param path The path of the file.
+   * @return Returns false if the file is not a valid timeline.
+   */
+  bool Open(const char* path);
+
+  /**
+   * @brief Returns the mapped timeline.
+   */
+  const TimelineFile& File() const { return file_; }
+
+  /**
+   * @brief Plays from the current position, from the start if the end was reached.
+   */
+  void Play();
+
+  /**
+   * @brief Stops the position where it is.
+   */
+  void Pause();
+
+  /**
+   * @brief Moves the position, the playback goes on if it was playing.
+   *
+   * @param position_us The new position from the start of the timeline, negative values are 0.
+   */
+  void Seek(int64_t position_us);
+
+  /**
+   * @brief Returns the position and whether it advances.
+   *
+   * @param position_us The position from the start of the timeline.
+   * @param is_playing Set to true while playing.
+   */
+  void Position(int64_t& position_us, bool& is_playing);
+};
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,275 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#define TIMING_WHEEL_TICK_US (1000)    // Length of a tick, the resolution of the wheel
+#define TIMING_WHEEL_BITS (8)          // Slots per level as a power of 2
+#define TIMING_WHEEL_LEVELS (4)        // Levels of the wheel, together they span 2^32 ticks (about 50 days)
+#define TIMING_WHEEL_SLOTS (1 << TIMING_WHEEL_BITS)
+#define TIMING_WHEEL_NIL (UINT32_MAX)  // No timer, ends the lists of the slots
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief TimingWheel is a hierarchical timing wheel of timers carrying a value of type T.
+ *
+ * Time is divided in ticks of TIMING_WHEEL_TICK_US. The first level has one slot per tick for the next
+ * TIMING_WHEEL_SLOTS ticks, and each following level has slots TIMING_WHEEL_SLOTS times longer. When a
+ * level wraps around, the timers of the next slot of the level above move down to their final slot.
+ * Adding and cancelling a timer are O(1), and advancing costs O(1) per tick plus the timers moved or
+ * expired, however many timers are active. The timers live in one pool linked by indices, so the wheel
+ * only allocates when the pool grows. Timers further than the span of the wheel wait in its last slot
+ * and are placed again on each turn.
+ *
+ * The wheel is not thread safe.
+ */
+template <typename T>
+class TimingWheel {
+ public:
+  using TimerId = uint64_t;  // Index of the timer in the low 32 bits, generation in the high 32 bits, never 0
+
+ private:
+  struct Node {
+    uint64_t tick;        // Tick at which the timer expires
+    uint32_t prev;        // Previous timer of the slot, TIMING_WHEEL_NIL for the first one
+    uint32_t next;        // Next timer of the slot, or next free node
+    uint32_t generation;  // Incremented each time the node is freed, tells reused nodes apart
+    uint16_t level;       // Level of the slot, TIMING_WHEEL_LEVELS if the node is free
+    uint16_t slot;        // Index of the slot in its level
+    T value;              // Value of the timer
+  };
+
+  std::chrono::steady_clock::time_point origin_;             // Time of tick 0
+  uint64_t current_;                                         // Last tick processed by Advance()
+  std::vector<Node> nodes_;                                  // Pool of the timers
+  uint32_t free_;                                            // First free node, TIMING_WHEEL_NIL if none
+  uint32_t heads_[TIMING_WHEEL_LEVELS][TIMING_WHEEL_SLOTS];  // First timer of each slot
+  size_t size_;                                              // Number of active timers
+
+  static std::chrono::microseconds Tick() { return std::chrono::microseconds(TIMING_WHEEL_TICK_US); }
+
+  // Returns the first tick at or after the given time
+  uint64_t CeilTick(std::chrono::steady_clock::time_point time) const {
+    if (time <= origin_) {
+      return 0;
+    }
+    auto elapsed = std::chrono::ceil<std::chrono::microseconds>(time - origin_);
+    return (static_cast<uint64_t>(elapsed.count()) + TIMING_WHEEL_TICK_US - 1) / TIMING_WHEEL_TICK_US;
+  }
+
+  // Returns the last tick at or before the given time
+  uint64_t FloorTick(std::chrono::steady_clock::time_point time) const {
+    if (time <= origin_) {
+      return 0;
+    }
+    auto elapsed = std::chrono::floor<std::chrono::microseconds>(time - origin_);
+    return static_cast<uint64_t>(elapsed.count()) / TIMING_WHEEL_TICK_US;
+  }
+
+  // Puts a node in the slot of its tick, relative to the current tick
+  void Link(uint32_t index) {
+    Node& node = nodes_[index];
+    uint64_t delta = node.tick - current_;
+    uint64_t tick = node.tick;
+    const uint64_t span = 1ULL << (TIMING_WHEEL_BITS * TIMING_WHEEL_LEVELS);
+    if (delta >= span) {
+      // Wait in the farthest slot, the node is placed again when that slot moves down
+      tick = current_ + span - 1;
+      delta = span - 1;
+    }
+    uint16_t level = 0;
+    while (delta >= (1ULL << (TIMING_WHEEL_BITS * (level + 1)))) {
+      level++;
+    }
+    uint16_t slot = static_cast<uint16_t>((tick >> (TIMING_WHEEL_BITS * level)) & (TIMING_WHEEL_SLOTS - 1));
+    node.level = level;
+    node.slot = slot;
+    node.prev = TIMING_WHEEL_NIL;
+    node.next = heads_[level][slot];
+    if (node.next != TIMING_WHEEL_NIL) {
+      nodes_[node.next].prev = index;
+    }
+    heads_[level][slot] = index;
+  }
+
+  // Removes a node from its slot
+  void Unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != TIMING_WHEEL_NIL) {
+      nodes_[node.prev].next = node.next;
+    } else {
+      heads_[node.level][node.slot] = node.next;
+    }
+    if (node.next != TIMING_WHEEL_NIL) {
+      nodes_[node.next].prev = node.prev;
+    }
+  }
+
+  // Returns a node to the pool
+  void Free(uint32_t index) {
+    Node& node = nodes_[index];
+    node.level = TIMING_WHEEL_LEVELS;
+    node.generation++;
+    node.value = T();
+    node.next = free_;
+    free_ = index;
+    size_--;
+  }
+
+  // Moves the timers of the slots reached by the current tick down to the lower levels
+  void Cascade() {
+    for (uint16_t level = 1; level < TIMING_WHEEL_LEVELS; level++) {
+      uint32_t slot = (current_ >> (TIMING_WHEEL_BITS * level)) & (TIMING_WHEEL_SLOTS - 1);
+      uint32_t index = heads_[level][slot];
+      heads_[level][slot] = TIMING_WHEEL_NIL;
+      while (index != TIMING_WHEEL_NIL) {
+        uint32_t next = nodes_[index].next;
+        Link(index);
+        index = next;
+      }
+      if (slot != 0) {
+        // The levels above only turn when this one wraps around
+        break;
+      }
+    }
+  }
+
+ public:
+  /**
+   * @param origin The time of the first tick, no timer expires before it.
+   */
+  explicit TimingWheel(std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now())
+      : origin_(origin), current_(0), free_(TIMING_WHEEL_NIL), size_(0) {
+    for (auto& level : heads_) {
+      for (auto& head : level) {
+        head = TIMING_WHEEL_NIL;
+      }
+    }
+  }
+
+  /**
+   * @brief Adds a timer.
+   *
+   * @param time The time at which the timer expires. A time already passed expires on the next tick.
+   * @param value The value passed back when the timer expires.
+   * @param now The current time. An empty wheel skips to it, so that the ticks of an idle period are not
+   * walked by the next Advance().
+   * @return Returns the id of the timer.
+   */
+  TimerId Add(std::chrono::steady_clock::time_point time, T value,
+              std::chrono::steady_clock::time_point now) {
+    if (size_ == 0) {
+      current_ = std::max(current_, FloorTick(now));
+    }
+    uint32_t index = free_;
+    if (index != TIMING_WHEEL_NIL) {
+      free_ = nodes_[index].next;
+    } else {
+      index = static_cast<uint32_t>(nodes_.size());
+      nodes_.push_back({});
+      nodes_[index].generation = 1;
+    }
+    Node& node = nodes_[index];
+    node.tick = std::max(CeilTick(time), current_ + 1);
+    node.value = std::move(value);
+    Link(index);
+    size_++;
+    return (static_cast<TimerId>(node.generation) << 32) | index;
+  }
+
+  /**
+   * @brief Removes a timer which has not expired yet.
+   *
+   * @param id The id returned by Add().
+   * @return Returns true if the timer was removed, false if it has expired or was already removed.
+   */
+  bool Cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id);
+    if (index >= nodes_.size() || nodes_[index].generation != static_cast<uint32_t>(id >> 32) ||
+        nodes_[index].level == TIMING_WHEEL_LEVELS) {
+      return false;
+    }
+    Unlink(index);
+    Free(index);
+    return true;
+  }
+
+  /**
+   * @brief Returns the number of active timers.
+   */
+  size_t Size() const { return size_; }
+
+  /**
+   * @brief Processes the ticks up to the given time and expires their timers.
+   *
+   * @param now The current time.
+   * @param expire The function called with the id and the value of each expired timer, in tick order.
+   * It must not modify the wheel.
+   */
+  template <typename Function>
+  void Advance(std::chrono::steady_clock::time_point now, Function&& expire) {
+    uint64_t target = FloorTick(now);
+    while (current_ < target) {
+      if (size_ == 0) {
+        // Nothing to move or expire on the ticks left
+        current_ = target;
+        break;
+      }
+      current_++;
+      if ((current_ & (TIMING_WHEEL_SLOTS - 1)) == 0) {
+        Cascade();
+      }
+      uint32_t slot = current_ & (TIMING_WHEEL_SLOTS - 1);
+      uint32_t index = heads_[0][slot];
+      heads_[0][slot] = TIMING_WHEEL_NIL;
+      while (index != TIMING_WHEEL_NIL) {
+        uint32_t next = nodes_[index].next;
+        TimerId id = (static_cast<TimerId>(nodes_[index].generation) << 32) | index;
+        T value = std::move(nodes_[index].value);
+        Free(index);
+        expire(id, value);
+        index = next;
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the time at which Advance() has something to do: the next tick with timers in the
+   * first level, or the next turn of the first level, whichever comes first. Must not be called when the
+   * wheel is empty.
+   */
+  std::chrono::steady_clock::time_point NextWakeup() const {
+    uint64_t tick = current_ + 1;
+    uint32_t slot = tick & (TIMING_WHEEL_SLOTS - 1);
+    while (slot != 0 && heads_[0][slot] == TIMING_WHEEL_NIL) {
+      tick++;
+      slot = tick & (TIMING_WHEEL_SLOTS - 1);
+    }
+    return origin_ + Tick() * tick;
+  }
+};
+
+}  // namespace sony::olfactory_device
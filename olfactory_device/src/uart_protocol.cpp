@@ -0,0 +1,104 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "uart_protocol.h"
+
+#include <string.h>
+
+namespace sony::olfactory_device {
+
+uint8_t Crc8(const uint8_t* data, size_t size) {
+  uint8_t crc = 0;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+bool FitsBinaryFrame(const DeviceCommand& command) {
+  return command.target >= 0 && command.target <= UINT8_MAX && command.level >= INT16_MIN &&
+         command.level <= INT16_MAX;
+}
+
+int EncodeCommand(UartProtocol protocol, const DeviceCommand& command, uint8_t sequence, char* buffer,
+                  size_t size) {
+  if (protocol == UartProtocol::TEXT) {
+    int length = FormatCommand(command, buffer, size);
+    return (length < 0 || static_cast<size_t>(length) >= size) ? -1 : length;
+  }
+
+  if (size < UART_FRAME_SIZE || !FitsBinaryFrame(command)) {
+    return -1;
+  }
+  uint16_t level = static_cast<uint16_t>(static_cast<int16_t>(command.level));
+  uint8_t* frame = reinterpret_cast<uint8_t*>(buffer);
+  frame[0] = UART_FRAME_SYNC;
+  frame[1] = static_cast<uint8_t>(command.opcode);
+  frame[2] = static_cast<uint8_t>(command.target);
+  frame[3] = static_cast<uint8_t>(level >> 8);
+  frame[4] = static_cast<uint8_t>(level & 0xff);
+  frame[5] = sequence;
+  frame[6] = Crc8(frame, UART_FRAME_SIZE - 1);
+  return UART_FRAME_SIZE;
+}
+
+UartFrameDecoder::UartFrameDecoder()
+    : frame_{}, size_(0), expected_(0), started_(false), errors_(0), lost_(0) {}
+
+bool UartFrameDecoder::Push(uint8_t byte, DeviceCommand& command, uint8_t& sequence) {
+  // Skip the bytes up to the start of a frame
+  if (size_ == 0 && byte != UART_FRAME_SYNC) {
+    return false;
+  }
+  frame_[size_++] = byte;
+  if (size_ < UART_FRAME_SIZE) {
+    return false;
+  }
+
+  if (Crc8(frame_, UART_FRAME_SIZE - 1) != frame_[UART_FRAME_SIZE - 1] ||
+      frame_[1] > static_cast<uint8_t>(CommandOpcode::RESET)) {
+    // Resynchronize on the next sync byte of the rejected frame
+    errors_++;
+    size_t next = 1;
+    while (next < UART_FRAME_SIZE && frame_[next] != UART_FRAME_SYNC) {
+      next++;
+    }
+    size_ = UART_FRAME_SIZE - next;
+    memmove(frame_, frame_ + next, size_);
+    return false;
+  }
+  size_ = 0;
+
+  command.opcode = static_cast<CommandOpcode>(frame_[1]);
+  command.target = frame_[2];
+  command.level = static_cast<int16_t>(static_cast<uint16_t>((frame_[3] << 8) | frame_[4]));
+  sequence = frame_[5];
+  if (started_ && sequence != expected_) {
+    lost_ += static_cast<uint8_t>(sequence - expected_);
+  }
+  expected_ = static_cast<uint8_t>(sequence + 1);
+  started_ = true;
+  return true;
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,109 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "device_command.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define UART_FRAME_SYNC (0xA5)                  // First byte of a binary frame
+#define UART_FRAME_SIZE (7)                     // Size of a binary frame, see EncodeCommand()
+#define UART_PROTOCOL_REQUEST "protocol(1)"     // Sent as text by the host to request the binary protocol
+#define UART_PROTOCOL_ACCEPTED "protocol(1)"    // Reply line of a device which switched to binary
+#define UART_PROTOCOL_REFUSED "protocol(0)"     // Reply line of a device which stays in text
+
+namespace sony::olfactory_device {
+
+/** How the commands are encoded on the serial link */
+enum class UartProtocol : int32_t {
+  TEXT = 0,    /**< ASCII text, e.g. "release(0, 3)", 12 to 15 bytes per command */
+  BINARY = 1,  /**< Binary frames with a sequence number and a CRC, 7 bytes per command */
+};
+
+/**
+ * @brief Computes the CRC-8 of the data (polynomial 0x07, initial value 0).
+ */
+uint8_t Crc8(const uint8_t* data, size_t size);
+
+/**
+ * @brief Checks if the command can be encoded as a binary frame.
+ *
+ * The target must be within 0 and 255, and the level within -32768 and 32767.
+ */
+bool FitsBinaryFrame(const DeviceCommand& command);
+
+/**
+ * @brief Encodes a command for the serial link.
+ *
+ * A binary frame is made of the sync byte 0xA5, the opcode, the target, the level as a 16-bit big-endian
+ * integer, the sequence number and the CRC-8 of the previous 6 bytes.
+ *
+ * @param protocol The encoding of the command.
+ * @param command The command to encode.
+ * @param sequence The sequence number of the binary frame, incremented for each command sent.
+ * @param buffer The buffer to write to.
+ * @param size The size of the buffer.
+ * @return Returns the length of the encoded command, or -1 if it does not fit the buffer or the frame.
+ */
+int EncodeCommand(UartProtocol protocol, const DeviceCommand& command, uint8_t sequence, char* buffer,
+                  size_t size);
+
+/**
+ * @brief UartFrameDecoder extracts the binary frames from the byte stream received by a device.
+ *
+ * The bytes are pushed one by one. A frame with a wrong CRC or opcode is counted as an error and the
+ * decoder resynchronizes on the next sync byte. Frames missing from the sequence numbers are counted
+ * as lost.
+ */
+class UartFrameDecoder {
+ private:
+  uint8_t frame_[UART_FRAME_SIZE];  // Bytes of the frame being received
+  size_t size_;                     // Number of bytes in frame_
+  uint8_t expected_;                // Sequence number of the next frame
+  bool started_;                    // A frame was decoded, expected_ is valid
+  uint64_t errors_;                 // Frames rejected
+  uint64_t lost_;                   // Frames missing from the sequence
+
+ public:
+  UartFrameDecoder();
+
+  /**
+   * @brief Adds a received byte.
+   *
+   * @param byte The byte received.
+   * @param command Receives the command when a frame is complete.
+   * @param sequence Receives the sequence number of the frame.
+   * @return Returns true if a frame was decoded, false otherwise.
+   */
+  bool Push(uint8_t byte, DeviceCommand& command, uint8_t& sequence);
+
+  /**
+   * @brief Returns the number of frames rejected because of their CRC or opcode.
+   */
+  uint64_t Errors() const { return errors_; }
+
+  /**
+   * @brief Returns the number of frames missing from the sequence numbers.
+   */
+  uint64_t Lost() const { return lost_; }
+};
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,149 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "uart_reader.h"
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace sony::olfactory_device {
+
+UartReader& UartReader::GetInstance() {
+  static UartReader instance;
+  return instance;
+}
+
+UartReader::UartReader()
+    : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)),
+      wake_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+      next_id_(1),
+      stop_(false) {
+  if (epoll_fd_ < 0 || wake_fd_ < 0) {
+    std::cerr << "[UartReader] Failed to set up epoll: " << strerror(errno) << std::endl;
+    return;
+  }
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.u64 = 0;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+}
+
+UartReader::~UartReader() {
+  if (thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    uint64_t value = 1;
+    (void)write(wake_fd_, &value, sizeof(value));
+    thread_.join();
+  }
+  if (wake_fd_ >= 0) {
+    close(wake_fd_);
+  }
+  if (epoll_fd_ >= 0) {
+    close(epoll_fd_);
+  }
+}
+
+bool UartReader::Add(const std::shared_ptr<Port>& port) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (epoll_fd_ < 0 || wake_fd_ < 0) {
+    return false;
+  }
+
+  port->id = next_id_++;
+  epoll_event event = {};
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.u64 = port->id;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, port->fd, &event) != 0) {
+    std::cerr << "[UartReader] Failed to watch serial port: " << strerror(errno) << std::endl;
+    return false;
+  }
+  ports_[port->id] = port;
+
+  if (!thread_.joinable()) {
+    thread_ = std::thread(&UartReader::Run, this);
+  }
+  return true;
+}
+
+void UartReader::Rearm(const std::shared_ptr<Port>& port) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (ports_.count(port->id) > 0) {
+    // Level triggered, so data which arrived since the last read is reported at once
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.u64 = port->id;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, port->fd, &event);
+  }
+}
+
+void UartReader::Remove(const std::shared_ptr<Port>& port) {
+  {
+    // The thread handles events with the lock held, so it is not using the port once the lock is taken
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ports_.erase(port->id) > 0) {
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, port->fd, nullptr);
+    }
+  }
+  std::lock_guard<std::mutex> lock(port->mutex);
+  port->closed = true;
+  port->changed.notify_all();
+}
+
+void UartReader::Run() {
+  epoll_event events[UART_READER_EVENTS_MAX];
+  while (true) {
+    int count = epoll_wait(epoll_fd_, events, UART_READER_EVENTS_MAX, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::cerr << "[UartReader] Failed to wait for serial ports: " << strerror(errno) << std::endl;
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+      return;
+    }
+    for (int i = 0; i < count; i++) {
+      // Ports removed after epoll_wait() returned are no longer in the map
+      auto it = ports_.find(events[i].data.u64);
+      if (it == ports_.end()) {
+        continue;
+      }
+      // Data or a hang up, which the session finds out when it reads
+      Port& port = *it->second;
+      std::lock_guard<std::mutex> port_lock(port.mutex);
+      port.readable = true;
+      port.changed.notify_all();
+    }
+  }
+}
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
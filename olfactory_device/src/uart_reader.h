@@ -0,0 +1,103 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#ifdef __linux__
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#define UART_READER_EVENTS_MAX (64)  // Ready ports handled per epoll_wait() call
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief UartReader runs a single epoll thread which watches all the serial ports of the process.
+ *
+ * Each UartSession adds its non-blocking port with Add(). When data arrives the reader thread marks the
+ * port readable and wakes the session waiting in RecvData(), which then reads the data itself straight
+ * into its FrameReceiver. A port is reported once, until the session has read all its data and calls
+ * Rearm(), so the thread never spins on a port nobody reads.
+ */
+class UartReader {
+ public:
+  /** A serial port serviced by the reader, shared with its UartSession */
+  struct Port {
+    int fd = -1;                       // Non-blocking file descriptor of the port
+    uint64_t id = 0;                   // Key of the port in the epoll set, set by Add()
+    std::mutex mutex;                  // Protects the members below
+    std::condition_variable changed;   // Notified when the port becomes readable or is closed
+    bool readable = true;              // Data may be available, cleared by the session before Rearm()
+    bool closed = false;               // The port was removed
+  };
+
+ private:
+  int epoll_fd_;                                              // epoll set of the ports
+  int wake_fd_;                                               // eventfd which wakes the thread to exit
+  std::mutex mutex_;                                          // Held while the thread handles events
+  std::unordered_map<uint64_t, std::shared_ptr<Port>> ports_;  // Ports by id
+  uint64_t next_id_;                                          // Id of the next port, 0 is the eventfd
+  std::thread thread_;                                        // Reader thread, started by the first Add()
+  bool stop_;                                                 // Reader thread must exit
+
+  UartReader();
+  ~UartReader();
+
+  void Run();
+
+ public:
+  /**
+   * @brief Returns the process-wide reader.
+   */
+  static UartReader& GetInstance();
+
+  /**
+   * @brief Starts watching a port.
+   *
+   * @param port The port, whose fd must be non-blocking.
+   * @return Returns true if the port was added, false otherwise.
+   */
+  bool Add(const std::shared_ptr<Port>& port);
+
+  /**
+   * @brief Reports the port again the next time it becomes readable.
+   *
+   * Call this after clearing readable, once a read of the port returned EAGAIN.
+   *
+   * @param port The port added with Add().
+   */
+  void Rearm(const std::shared_ptr<Port>& port);
+
+  /**
+   * @brief Stops watching a port and marks it closed.
+   *
+   * Once this returns, the reader thread no longer uses the fd of the port, which may then be closed.
+   *
+   * @param port The port added with Add().
+   */
+  void Remove(const std::shared_ptr<Port>& port);
+};
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
@@ -19,16 +19,22 @@
  */
 
 #include "uart_session.h"
+#ifdef _WIN32
+#include "async_log.h"
 
+#include <chrono>
 #include <iostream>
 #include <iomanip> // for std::setw, std::setfill
+#include <string_view>
 
 namespace sony::olfactory_device {
 
 // Constructor
 UartSession::UartSession()
   : uart_handle_(INVALID_HANDLE_VALUE),
-    connected_(false) {}
+    connected_(false),
+    requested_(UartProtocol::TEXT),
+    protocol_(UartProtocol::TEXT) {}
 
 // Destructor
 UartSession::~UartSession() {
@@ -90,13 +96,64 @@ bool UartSession::Open(const char* device_id) {
     return false;
   }
 
+  // Commands are written by the writer thread, which owns the write side of the handle
+  HANDLE handle = uart_handle_;
+  UartWriteQueue::WriteFunction write = [this, handle](const char* data, size_t size) {
+    DWORD bytes_written;
+    if (!WriteFile(handle, data, static_cast<DWORD>(size), &bytes_written, nullptr)) {
+      std::cerr << "[UartSession] Failed to send data over UART." << std::endl;
+      return false;
+    }
+    if (protocol_ == UartProtocol::BINARY) {
+      ConsoleLog(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE, "[UartSession] Data sent: {} frames",
+                 size / UART_FRAME_SIZE);
+    } else {
+      ConsoleLog(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE, "[UartSession] Data sent: {}",
+                 std::string_view(data, size));
+    }
+    return true;
+  };
+
+  receiver_.Clear(receiver_.Mode());
   std::cout << "[UartSession] UART initialized successfully for port: " << port_num << " with baud rate: " << dcb_serial_params.BaudRate << std::endl;
   connected_ = true;
+  protocol_ = UartProtocol::TEXT;
+  if (requested_ == UartProtocol::BINARY) {
+    protocol_ = Negotiate(write);
+  }
+  writer_ = std::make_unique<UartWriteQueue>(std::move(write), protocol_);
   return true;
 }
 
+UartProtocol UartSession::Negotiate(const UartWriteQueue::WriteFunction& write) {
+  if (!write(UART_PROTOCOL_REQUEST, strlen(UART_PROTOCOL_REQUEST))) {
+    return UartProtocol::TEXT;
+  }
+
+  // Skip the other lines of the device until its reply
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(UART_NEGOTIATE_TIMEOUT_MS);
+  std::string_view frame;
+  for (;;) {
+    auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0 || !RecvFrame(frame, static_cast<int>(remaining.count())) ||
+        frame == UART_PROTOCOL_REFUSED) {
+      break;
+    }
+    if (frame == UART_PROTOCOL_ACCEPTED) {
+      std::cout << "[UartSession] Binary protocol negotiated." << std::endl;
+      return UartProtocol::BINARY;
+    }
+  }
+  std::cout << "[UartSession] Binary protocol not accepted by the device, using text." << std::endl;
+  return UartProtocol::TEXT;
+}
+
 void UartSession::Close() {
   if (connected_) {
+    // Write the commands already sent before closing the handle
+    writer_->Stop();
+    writer_.reset();
     CloseHandle(uart_handle_);
     uart_handle_ = INVALID_HANDLE_VALUE;
     connected_ = false;
@@ -108,46 +165,68 @@ bool UartSession::IsConnected() const {
   return connected_;
 }
 
-bool UartSession::SendData(const std::string& data) {
+bool UartSession::SendData(const DeviceCommand& command) {
   if (!connected_) {
     std::cerr << "[UartSession] UART not connected." << std::endl;
     return false;
   }
+  return writer_->Push(command);
+}
 
-  // Write data to UART (platform-dependent)
-  DWORD bytes_written;
-  if (!WriteFile(uart_handle_, data.c_str(), static_cast<DWORD>(data.size()), &bytes_written, nullptr)) {
-    std::cerr << "[UartSession] Failed to send data over UART." << std::endl;
+bool UartSession::SendDataBatch(const std::vector<DeviceCommand>& commands) {
+  if (!connected_) {
+    std::cerr << "[UartSession] UART not connected." << std::endl;
     return false;
   }
-
-  std::cout << "[UartSession] Data sent: " << data << std::endl;
+  for (const auto& command : commands) {
+    if (!writer_->Push(command)) {
+      return false;
+    }
+  }
   return true;
 }
 
+bool UartSession::Flush() {
+  if (!connected_) {
+    std::cerr << "[UartSession] UART not connected." << std::endl;
+    return false;
+  }
+  return writer_->Flush();
+}
+
 bool UartSession::RecvData(std::string& data) {
+  std::string_view frame;
+  if (!RecvFrame(frame)) {
+    return false;
+  }
+  data.assign(frame);
+  std::cout << "[UartSession] Data recv: " << data << std::endl;
+  return true;
+}
+
+bool UartSession::RecvFrame(std::string_view& frame, int timeout_ms) {
   if (!connected_) {
     std::cerr << "[UartSession] UART not connected." << std::endl;
     return false;
   }
 
-  // Read data from UART (platform-dependent)
-  char buffer[1024] = { 0 };
-  DWORD bytes_read = 0;
-  while (true) {
-    if (ReadFile(uart_handle_, buffer, sizeof(buffer) - 1, &bytes_read, nullptr)) {
-      if (bytes_read > 0) {
-        buffer[bytes_read] = '\0';
-//      std::cout << "bytes_read: " << bytes_read << std::endl;
-        data = buffer;
-        std::cout << "[UartSession] Data recv: " << data << std::endl;
-        return true;
-      }
-    } else {
+  // Read data from UART (platform-dependent) straight into the receive buffer. ReadFile returns after the
+  // read timeout of the port when nothing arrives.
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!receiver_.Next(frame)) {
+    if (timeout_ms >= 0 && std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    size_t size = 0;
+    char* buffer = receiver_.WritePointer(size);
+    DWORD bytes_read = 0;
+    if (!ReadFile(uart_handle_, buffer, static_cast<DWORD>(size), &bytes_read, nullptr)) {
       std::cerr << "[UartSession] Failed to receive data over UART." << std::endl;
       return false;
     }
+    receiver_.Commit(bytes_read);
   }
+  return true;
 }
 
 bool UartSession::IsScentEmissionAvailable() {
@@ -159,3 +238,4 @@ bool UartSession::IsScentEmissionAvailable() {
 }
 
 }  // namespace sony::olfactory_device
+#endif  // _WIN32
@@ -20,12 +20,22 @@
 
 #pragma once
 #include "device_session_if.h"
+#include "frame_receiver.h"
+#include "uart_protocol.h"
+#include "uart_write_queue.h"
 #include <string>
+#include <string_view>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include "uart_reader.h"
+#endif
 #include <thread>
 #include <atomic>
 #include <queue>
 
+#define UART_NEGOTIATE_TIMEOUT_MS (200)  // Longest wait for the reply to the protocol request
+
 namespace sony::olfactory_device {
 
 /**
@@ -33,11 +43,32 @@ namespace sony::olfactory_device {
  *
  * This class manages the UART session, providing methods to open, close, check connection status,
  * and send data over a UART connection.
+ *
+ * On Windows the port is opened with CreateFileW. On Linux it is configured with termios and read by the
+ * shared UartReader thread, which serves the data to RecvData() without polling.
+ *
+ * The commands are written by the UartWriteQueue thread of the session, so SendData() returns without
+ * waiting for the port and a burst of commands is written at once.
+ *
+ * The commands are sent as text by default. When the binary protocol is requested, by SetProtocol() or
+ * "protocol": "binary" in device.json, Open() sends "protocol(1)" and switches to binary frames if the
+ * device replies with the line "protocol(1)".
  */
 class UartSession : public DeviceSessionIF {
  private:
+#ifdef _WIN32
   HANDLE uart_handle_;  // Handle to the UART connection
+#else
+  std::shared_ptr<UartReader::Port> port_;  // Non-blocking port and its received data
+#endif
   bool connected_;      // Connection status
+  FrameReceiver receiver_;  // Reassembles the received frames
+  std::unique_ptr<UartWriteQueue> writer_;  // Writes the commands in the background
+  UartProtocol requested_;  // Protocol requested at the next Open()
+  UartProtocol protocol_;   // Protocol of the commands, negotiated by Open()
+
+  // Requests the binary protocol, returns the protocol accepted by the device
+  UartProtocol Negotiate(const UartWriteQueue::WriteFunction& write);
 
  public:
   UartSession();
@@ -46,13 +77,13 @@ class UartSession : public DeviceSessionIF {
   /**
    * @brief Opens a UART session with the specified device.
    *
-   * @param device_id The identifier of the UART device (e.g., COM port name).
+   * @param device_id The identifier of the UART device (e.g., COM port name, or /dev/ttyUSB0 on Linux).
    * @return Returns true if the connection was successfully established, false otherwise.
    */
   bool Open(const char* device_id) override;
 
   /**
-   * @brief Closes the UART session.
+   * @brief Closes the UART session, after writing the commands already sent.
    */
   void Close() override;
 
@@ -64,21 +95,74 @@ class UartSession : public DeviceSessionIF {
   bool IsConnected() const override;
 
   /**
-   * @brief Sends data over the UART connection.
+   * @brief Sends a command over the UART connection.
+   *
+   * The command is queued and written by the writer thread, see Flush().
+   *
+   * @param command The command to send over the UART.
+   * @return Returns true if the command was queued, false otherwise.
+   */
+  bool SendData(const DeviceCommand& command) override;
+
+  /**
+   * @brief Sends several commands over the UART connection.
+   *
+   * The commands are queued together and written by the writer thread, see Flush().
+   *
+   * @param commands The commands to send, in order.
+   * @return Returns true if the commands were queued, false otherwise.
+   */
+  bool SendDataBatch(const std::vector<DeviceCommand>& commands) override;
+
+  /**
+   * @brief Waits until the commands sent before the call are written to the port.
    *
-   * @param data The data to send over the UART.
-   * @return Returns true if the data was successfully sent, false otherwise.
+   * @return Returns false if a write failed since the previous Flush(), true otherwise.
    */
-  bool SendData(const std::string& data) override;
+  bool Flush();
 
   /**
    * @brief Received data over the UART connection.
    *
+   * Returns one complete frame, copied from RecvFrame().
+   *
    * @param data The data to receive over the UART.
    * @return Returns true if the data was successfully received, false otherwise.
    */
   bool RecvData(std::string& data) override;
 
+  /**
+   * @brief Receives the next complete frame without copying it.
+   *
+   * Frames are lines ending with "\n" or "\r\n" by default, see SetFrameMode(). The data is read straight
+   * into the receive buffer and frames split across reads are reassembled. Waits until a frame is
+   * complete. On Linux, also returns when the session is closed or the port hangs up.
+   *
+   * @param frame Receives the frame, which stays valid until the next receive.
+   * @param timeout_ms The longest wait in milliseconds, or -1 to wait without limit.
+   * @return Returns true if a frame was received, false otherwise.
+   */
+  bool RecvFrame(std::string_view& frame, int timeout_ms = -1);
+
+  /**
+   * @brief Changes how the received frames are delimited, discarding the data not received yet.
+   *
+   * @param mode How frames are delimited.
+   */
+  void SetFrameMode(FrameMode mode) { receiver_.Clear(mode); }
+
+  /**
+   * @brief Sets the protocol requested by the next Open().
+   *
+   * @param protocol UartProtocol::BINARY to negotiate the binary frames, UartProtocol::TEXT otherwise.
+   */
+  void SetProtocol(UartProtocol protocol) override { requested_ = protocol; }
+
+  /**
+   * @brief Returns the protocol negotiated by Open().
+   */
+  UartProtocol Protocol() const { return protocol_; }
+
   /**
    * @brief Check if scent emission is available for the specified device.
    *
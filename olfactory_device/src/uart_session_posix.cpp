@@ -0,0 +1,254 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "uart_session.h"
+#ifdef __linux__
+#include "async_log.h"
+#include "serial_port.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+#include <poll.h>
+#include <unistd.h>
+
+#define UART_WRITE_TIMEOUT_MS (1000)  // Longest wait for the port to accept more data
+
+namespace sony::olfactory_device {
+
+// Writes all the data to the non-blocking port, waiting while its output buffer is full
+static bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written > 0) {
+      data += written;
+      size -= written;
+      continue;
+    }
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0 && errno == EAGAIN) {
+      pollfd writable = {fd, POLLOUT, 0};
+      if (poll(&writable, 1, UART_WRITE_TIMEOUT_MS) > 0) {
+        continue;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
+// Constructor
+UartSession::UartSession()
+  : connected_(false),
+    requested_(UartProtocol::TEXT),
+    protocol_(UartProtocol::TEXT) {}
+
+// Destructor
+UartSession::~UartSession() {
+  if (connected_) {
+    Close();
+  }
+}
+
+bool UartSession::Open(const char* device_id) {
+  std::cout << "[UartSession] device_id: " << device_id << std::endl;
+  int fd = OpenSerialPort(device_id, true);
+  if (fd < 0) {
+    std::cerr << "[UartSession] Failed to open UART port: " << device_id << std::endl;
+    return false;
+  }
+
+  auto port = std::make_shared<UartReader::Port>();
+  port->fd = fd;
+  if (!UartReader::GetInstance().Add(port)) {
+    std::cerr << "[UartSession] Failed to start reading UART port: " << device_id << std::endl;
+    close(fd);
+    return false;
+  }
+
+  // Commands are written by the writer thread, which owns the write side of the fd
+  UartWriteQueue::WriteFunction write = [this, fd](const char* data, size_t size) {
+    if (!WriteAll(fd, data, size)) {
+      std::cerr << "[UartSession] Failed to send data over UART: " << strerror(errno) << std::endl;
+      return false;
+    }
+    if (protocol_ == UartProtocol::BINARY) {
+      ConsoleLog(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE, "[UartSession] Data sent: {} frames",
+                 size / UART_FRAME_SIZE);
+    } else {
+      ConsoleLog(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE, "[UartSession] Data sent: {}",
+                 std::string_view(data, size));
+    }
+    return true;
+  };
+
+  std::cout << "[UartSession] UART initialized successfully for port: " << device_id << " with baud rate: 115200"
+            << std::endl;
+  port_ = port;
+  receiver_.Clear(receiver_.Mode());
+  connected_ = true;
+  protocol_ = UartProtocol::TEXT;
+  if (requested_ == UartProtocol::BINARY) {
+    protocol_ = Negotiate(write);
+  }
+  writer_ = std::make_unique<UartWriteQueue>(std::move(write), protocol_);
+  return true;
+}
+
+UartProtocol UartSession::Negotiate(const UartWriteQueue::WriteFunction& write) {
+  if (!write(UART_PROTOCOL_REQUEST, strlen(UART_PROTOCOL_REQUEST))) {
+    return UartProtocol::TEXT;
+  }
+
+  // Skip the other lines of the device until its reply
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(UART_NEGOTIATE_TIMEOUT_MS);
+  std::string_view frame;
+  for (;;) {
+    auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0 || !RecvFrame(frame, static_cast<int>(remaining.count())) ||
+        frame == UART_PROTOCOL_REFUSED) {
+      break;
+    }
+    if (frame == UART_PROTOCOL_ACCEPTED) {
+      std::cout << "[UartSession] Binary protocol negotiated." << std::endl;
+      return UartProtocol::BINARY;
+    }
+  }
+  std::cout << "[UartSession] Binary protocol not accepted by the device, using text." << std::endl;
+  return UartProtocol::TEXT;
+}
+
+void UartSession::Close() {
+  if (connected_) {
+    // Write the commands already sent, and the reader thread releases the fd, before it is closed
+    writer_->Stop();
+    writer_.reset();
+    UartReader::GetInstance().Remove(port_);
+    close(port_->fd);
+    port_.reset();
+    connected_ = false;
+    std::cout << "[UartSession] UART connection closed." << std::endl;
+  }
+}
+
+bool UartSession::IsConnected() const {
+  return connected_;
+}
+
+bool UartSession::SendData(const DeviceCommand& command) {
+  if (!connected_) {
+    std::cerr << "[UartSession] UART not connected." << std::endl;
+    return false;
+  }
+  return writer_->Push(command);
+}
+
+bool UartSession::SendDataBatch(const std::vector<DeviceCommand>& commands) {
+  if (!connected_) {
+    std::cerr << "[UartSession] UART not connected." << std::endl;
+    return false;
+  }
+  for (const auto& command : commands) {
+    if (!writer_->Push(command)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool UartSession::Flush() {
+  if (!connected_) {
+    std::cerr << "[UartSession] UART not connected." << std::endl;
+    return false;
+  }
+  return writer_->Flush();
+}
+
+bool UartSession::RecvData(std::string& data) {
+  std::string_view frame;
+  if (!RecvFrame(frame)) {
+    return false;
+  }
+  data.assign(frame);
+  std::cout << "[UartSession] Data recv: " << data << std::endl;
+  return true;
+}
+
+bool UartSession::RecvFrame(std::string_view& frame, int timeout_ms) {
+  std::shared_ptr<UartReader::Port> port = port_;
+  if (!connected_ || !port) {
+    std::cerr << "[UartSession] UART not connected." << std::endl;
+    return false;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!receiver_.Next(frame)) {
+    // Read straight into the receive buffer
+    size_t size = 0;
+    char* buffer = receiver_.WritePointer(size);
+    ssize_t length = read(port->fd, buffer, size);
+    if (length > 0) {
+      receiver_.Commit(length);
+      continue;
+    }
+    if (length < 0 && errno == EINTR) {
+      continue;
+    }
+    if (length < 0 && errno == EAGAIN) {
+      // Everything was read, wait for the reader thread to report more data
+      std::unique_lock<std::mutex> lock(port->mutex);
+      port->readable = false;
+      lock.unlock();
+      UartReader::GetInstance().Rearm(port);
+      lock.lock();
+      auto ready = [&port]() { return port->readable || port->closed; };
+      if (timeout_ms < 0) {
+        port->changed.wait(lock, ready);
+      } else if (!port->changed.wait_until(lock, deadline, ready)) {
+        return false;
+      }
+      if (port->closed) {
+        return false;
+      }
+      continue;
+    }
+    std::cerr << "[UartSession] Failed to receive data over UART: "
+              << (length == 0 ? "hung up" : strerror(errno)) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool UartSession::IsScentEmissionAvailable() {
+  if (!connected_) {
+    std::cerr << "[UartSession] UART not connected." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
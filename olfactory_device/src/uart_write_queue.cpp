@@ -0,0 +1,190 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "uart_write_queue.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace sony::olfactory_device {
+
+UartWriteQueue::UartWriteQueue(WriteFunction write, UartProtocol protocol)
+    : ring_(new Entry[UART_WRITE_QUEUE_SIZE]),
+      head_(0),
+      tail_(0),
+      write_(std::move(write)),
+      protocol_(protocol),
+      sleeping_(false),
+      running_(true),
+      done_(0),
+      failures_(0),
+      flushed_failures_(0),
+      stop_(false),
+      exited_(false) {
+  static_assert((UART_WRITE_QUEUE_SIZE & (UART_WRITE_QUEUE_SIZE - 1)) == 0, "must be a power of 2");
+  for (size_t i = 0; i < UART_WRITE_QUEUE_SIZE; i++) {
+    ring_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  pending_.reserve(UART_WRITE_QUEUE_SIZE * UART_WRITE_ENTRY_MAX);
+  thread_ = std::thread(&UartWriteQueue::Run, this);
+}
+
+UartWriteQueue::~UartWriteQueue() {
+  Stop();
+}
+
+bool UartWriteQueue::Push(const DeviceCommand& command) {
+  if (!running_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  // A claimed entry must be written, so check the command first
+  if (protocol_ == UartProtocol::BINARY && !FitsBinaryFrame(command)) {
+    return false;
+  }
+
+  // Claim an entry, the producers compete on head_ only
+  size_t position = head_.load(std::memory_order_relaxed);
+  Entry* entry = nullptr;
+  for (;;) {
+    entry = &ring_[position & (UART_WRITE_QUEUE_SIZE - 1)];
+    size_t sequence = entry->sequence.load(std::memory_order_acquire);
+    intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The ring is full, a command is never dropped so wait for the writer thread to free an entry
+      if (!running_.load()) {
+        return false;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_one();
+      }
+      std::this_thread::yield();
+      position = head_.load(std::memory_order_relaxed);
+    } else {
+      position = head_.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Encode the command straight into the entry, numbering the binary frames in the order of the ring
+  int length =
+      EncodeCommand(protocol_, command, static_cast<uint8_t>(position), entry->data, sizeof(entry->data));
+  entry->length = static_cast<uint8_t>(std::max(length, 0));
+  // Publish the entry before reading sleeping_, see Run()
+  entry->sequence.store(position + 1);
+
+  // Wake the writer thread only if it is waiting
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_one();
+  }
+  return true;
+}
+
+bool UartWriteQueue::Flush() {
+  size_t target = head_.load();
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.notify_one();
+  written_.wait(lock, [this, target]() { return done_ >= target || exited_; });
+  bool failed = failures_ != flushed_failures_;
+  flushed_failures_ = failures_;
+  return !failed;
+}
+
+void UartWriteQueue::Stop() {
+  running_ = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stop_) {
+      return;
+    }
+    stop_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+}
+
+uint64_t UartWriteQueue::Failures() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failures_;
+}
+
+bool UartWriteQueue::Drain() {
+  // Take everything pending, handing the entries back to the producers before the write
+  pending_.clear();
+  for (;;) {
+    Entry& entry = ring_[tail_ & (UART_WRITE_QUEUE_SIZE - 1)];
+    if (entry.sequence.load(std::memory_order_acquire) != tail_ + 1) {
+      break;
+    }
+    pending_.append(entry.data, entry.length);
+    entry.sequence.store(tail_ + UART_WRITE_QUEUE_SIZE, std::memory_order_release);
+    tail_++;
+  }
+  if (pending_.empty()) {
+    return false;
+  }
+
+  bool written = write_(pending_.data(), pending_.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = tail_;
+    if (!written) {
+      failures_++;
+    }
+  }
+  written_.notify_all();
+  return true;
+}
+
+void UartWriteQueue::Run() {
+  for (;;) {
+    // The commands pushed during a write are coalesced into the next one
+    while (Drain()) {
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stop_) {
+      break;
+    }
+    // Announce the wait before checking the ring again, so that either the producer sees sleeping_ or
+    // its command is seen here
+    sleeping_.store(true);
+    Entry& entry = ring_[tail_ & (UART_WRITE_QUEUE_SIZE - 1)];
+    if (entry.sequence.load() != tail_ + 1) {
+      cv_.wait_for(lock, std::chrono::milliseconds(UART_WRITE_IDLE_WAIT_MS));
+    }
+    sleeping_.store(false);
+  }
+
+  // Write what was pushed before Stop()
+  while (Drain()) {
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    exited_ = true;
+  }
+  written_.notify_all();
+}
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,126 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include "device_command.h"
+#include "uart_protocol.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+
+#define UART_WRITE_QUEUE_SIZE (1024)    // Number of entries of the ring buffer, must be a power of 2
+#define UART_WRITE_ENTRY_MAX (64)       // Maximum length of an encoded command
+#define UART_WRITE_IDLE_WAIT_MS (100)   // Longest wait of the writer thread without being woken
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief UartWriteQueue writes the commands of a UartSession from a background thread.
+ *
+ * The callers encode their commands directly into a fixed-size lock-free ring buffer and return without
+ * waiting for the port. The writer thread takes everything pending at once and writes it with a single
+ * call, so a burst of small commands becomes one large write. The commands of each caller are written in
+ * the order they were pushed. When the ring buffer is full the callers wait for the writer thread rather
+ * than dropping a command. With the binary protocol, the sequence number of a frame is its position in
+ * the ring, so the numbers follow the order of the frames on the wire.
+ *
+ * Write errors are not reported to the callers of Push(), see Flush() and Failures().
+ */
+class UartWriteQueue {
+ public:
+  /** Writes all the data to the port, returns false on error */
+  using WriteFunction = std::function<bool(const char* data, size_t size)>;
+
+ private:
+  struct Entry {
+    std::atomic<size_t> sequence;     // Position of the entry in the ring, see Push() and Drain()
+    uint8_t length;                   // Length of data
+    char data[UART_WRITE_ENTRY_MAX];  // Encoded command, not null-terminated
+  };
+
+  std::unique_ptr<Entry[]> ring_;     // Ring buffer of UART_WRITE_QUEUE_SIZE entries
+  std::atomic<size_t> head_;          // Next position to write, shared by the producers
+  size_t tail_;                       // Next position to read, only used by the thread
+  std::string pending_;               // Data of the next write, only used by the thread
+  WriteFunction write_;               // Writes to the port
+  UartProtocol protocol_;             // Encoding of the commands
+
+  std::mutex mutex_;                  // Protects the members below
+  std::condition_variable cv_;        // Wakes the writer thread
+  std::condition_variable written_;   // Notified after each write, see Flush()
+  std::atomic<bool> sleeping_;        // The writer thread waits on cv_
+  std::atomic<bool> running_;         // Commands are accepted
+  size_t done_;                       // Entries written or failed
+  uint64_t failures_;                 // Failed writes
+  uint64_t flushed_failures_;         // Failed writes already reported by Flush()
+  bool stop_;                         // The writer thread must exit
+  bool exited_;                       // The writer thread wrote its last commands
+  std::thread thread_;                // Writer thread
+
+  void Run();
+  bool Drain();
+
+ public:
+  /**
+   * @brief Starts the writer thread.
+   *
+   * @param write Called by the writer thread with the coalesced data.
+   * @param protocol The encoding of the commands.
+   */
+  explicit UartWriteQueue(WriteFunction write, UartProtocol protocol = UartProtocol::TEXT);
+
+  /**
+   * @brief Writes the remaining commands and stops the writer thread.
+   */
+  ~UartWriteQueue();
+
+  /**
+   * @brief Encodes a command into the ring buffer, to be written by the writer thread.
+   *
+   * @param command The command to write.
+   * @return Returns false if the queue is stopped or the command cannot be encoded.
+   */
+  bool Push(const DeviceCommand& command);
+
+  /**
+   * @brief Waits until the commands pushed before the call are written.
+   *
+   * @return Returns false if a write failed since the previous Flush(), true otherwise.
+   */
+  bool Flush();
+
+  /**
+   * @brief Writes the remaining commands and stops the writer thread. Later commands are refused.
+   */
+  void Stop();
+
+  /**
+   * @brief Returns the number of failed writes since the construction.
+   */
+  uint64_t Failures();
+};
+
+}  // namespace sony::olfactory_device
@@ -0,0 +1,167 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "udp_transmit_batch.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+#include <spdlog/spdlog.h>
+#include "ip/UdpSocket.h"
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace sony::olfactory_device {
+
+thread_local UdpTransmitBatch* UdpTransmitBatch::current_ = nullptr;
+thread_local int32_t UdpTransmitBatch::current_tag_ = -1;
+
+#ifdef __linux__
+UdpTransmitBatch::UdpTransmitBatch() : socket_(-1) {}
+
+UdpTransmitBatch::~UdpTransmitBatch() {
+  if (socket_ >= 0) {
+    close(socket_);
+  }
+}
+#else
+UdpTransmitBatch::UdpTransmitBatch() : socket_(nullptr) {}
+
+UdpTransmitBatch::~UdpTransmitBatch() {
+  delete socket_;
+}
+#endif
+
+void UdpTransmitBatch::Add(const IpEndpointName& endpoint, const char* data, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t offset = data_.size();
+  data_.insert(data_.end(), data, data + size);
+  packets_.push_back({endpoint, offset, size, current_tag_});
+}
+
+size_t UdpTransmitBatch::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return packets_.size();
+}
+
+size_t UdpTransmitBatch::Flush(std::vector<int32_t>* failed_tags) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (packets_.empty()) {
+    return 0;
+  }
+  size_t failed = 0;
+
+#ifdef __linux__
+  if (socket_ < 0) {
+    socket_ = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (socket_ < 0) {
+      spdlog::error("{}: Failed to open UDP socket ({}).", __func__, strerror(errno));
+      failed = packets_.size();
+      if (failed_tags != nullptr) {
+        for (const Packet& packet : packets_) {
+          failed_tags->push_back(packet.tag);
+        }
+      }
+      data_.clear();
+      packets_.clear();
+      return failed;
+    }
+  }
+
+  std::vector<sockaddr_in> addresses(std::min<size_t>(packets_.size(), UDP_TRANSMIT_BATCH_MAX));
+  std::vector<iovec> iovecs(addresses.size());
+  std::vector<mmsghdr> messages(addresses.size());
+  for (size_t first = 0; first < packets_.size();) {
+    size_t count = std::min<size_t>(packets_.size() - first, UDP_TRANSMIT_BATCH_MAX);
+    for (size_t i = 0; i < count; i++) {
+      const Packet& packet = packets_[first + i];
+      addresses[i] = {};
+      addresses[i].sin_family = AF_INET;
+      addresses[i].sin_addr.s_addr = htonl(static_cast<uint32_t>(packet.endpoint.address));
+      addresses[i].sin_port = htons(static_cast<uint16_t>(packet.endpoint.port));
+      iovecs[i].iov_base = &data_[packet.offset];
+      iovecs[i].iov_len = packet.size;
+      messages[i] = {};
+      messages[i].msg_hdr.msg_name = &addresses[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+      messages[i].msg_hdr.msg_iov = &iovecs[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent = sendmmsg(socket_, messages.data(), static_cast<unsigned int>(count), 0);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // sendmmsg() reports the error of the first datagram only, skip it and send the rest
+      spdlog::error("{}: Failed to send UDP datagram ({}).", __func__, strerror(errno));
+      if (failed_tags != nullptr) {
+        failed_tags->push_back(packets_[first].tag);
+      }
+      failed++;
+      first++;
+    } else {
+      first += sent;
+    }
+  }
+#else
+  if (socket_ == nullptr) {
+    try {
+      socket_ = new UdpSocket();
+    } catch (const std::exception& e) {
+      spdlog::error("{}: Failed to open UDP socket ({}).", __func__, e.what());
+      failed = packets_.size();
+      if (failed_tags != nullptr) {
+        for (const Packet& packet : packets_) {
+          failed_tags->push_back(packet.tag);
+        }
+      }
+      data_.clear();
+      packets_.clear();
+      return failed;
+    }
+  }
+
+  for (const Packet& packet : packets_) {
+    try {
+      socket_->SendTo(packet.endpoint, &data_[packet.offset], packet.size);
+    } catch (const std::exception& e) {
+      spdlog::error("{}: Failed to send UDP datagram ({}).", __func__, e.what());
+      if (failed_tags != nullptr) {
+        failed_tags->push_back(packet.tag);
+      }
+      failed++;
+    }
+  }
+#endif
+
+  data_.clear();
+  packets_.clear();
+  return failed;
+}
+
+}  // namespace sony::olfactory_device
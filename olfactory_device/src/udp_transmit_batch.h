@@ -0,0 +1,125 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "ip/IpEndpointName.h"
+
+#define UDP_TRANSMIT_BATCH_MAX (1024)  // Datagrams handed to the kernel per sendmmsg() call
+
+class UdpSocket;
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief UdpTransmitBatch collects outbound UDP datagrams for many endpoints and sends them together.
+ *
+ * While a batch is installed on a thread with Scope, OscSession adds its packets to the batch instead
+ * of sending them. Flush() then sends every collected datagram. On Linux all the datagrams go out
+ * with sendmmsg(), up to UDP_TRANSMIT_BATCH_MAX per system call. Other platforms send them one by one
+ * from a single socket. Add() may be called from several threads at once.
+ */
+class UdpTransmitBatch {
+ private:
+  struct Packet {
+    IpEndpointName endpoint;  // Destination of the datagram
+    size_t offset;            // Start of the datagram in data_
+    size_t size;              // Size of the datagram
+    int32_t tag;              // Tag of the scope which added the datagram
+  };
+
+  std::mutex mutex_;             // Protects the members below
+  std::vector<char> data_;       // Contents of all the datagrams, back to back
+  std::vector<Packet> packets_;  // Datagrams in the order they were added
+#ifdef __linux__
+  int socket_;                   // Socket used by sendmmsg(), -1 until the first Flush()
+#else
+  UdpSocket* socket_;            // Socket used by SendTo(), nullptr until the first Flush()
+#endif
+
+  static thread_local UdpTransmitBatch* current_;
+  static thread_local int32_t current_tag_;
+
+ public:
+  UdpTransmitBatch();
+  ~UdpTransmitBatch();
+
+  UdpTransmitBatch(const UdpTransmitBatch&) = delete;
+  UdpTransmitBatch& operator=(const UdpTransmitBatch&) = delete;
+
+  /**
+   * @brief Installs a batch on the calling thread for the lifetime of the scope.
+   *
+   * The batch which was installed before, if any, is restored when the scope ends. The datagrams added
+   * within the scope carry its tag, which Flush() reports for the datagrams which could not be sent.
+   */
+  class Scope {
+   private:
+    UdpTransmitBatch* previous_;
+    int32_t previous_tag_;
+
+   public:
+    explicit Scope(UdpTransmitBatch& batch, int32_t tag = -1)
+        : previous_(current_), previous_tag_(current_tag_) {
+      current_ = &batch;
+      current_tag_ = tag;
+    }
+    ~Scope() {
+      current_ = previous_;
+      current_tag_ = previous_tag_;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+  /**
+   * @brief Returns the batch installed on the calling thread, or nullptr if datagrams are sent directly.
+   */
+  static UdpTransmitBatch* Current() { return current_; }
+
+  /**
+   * @brief Adds a datagram to the batch, tagged with the tag of the scope installed on the calling thread.
+   *
+   * @param endpoint The destination of the datagram.
+   * @param data The contents of the datagram, copied into the batch.
+   * @param size The size of the datagram.
+   */
+  void Add(const IpEndpointName& endpoint, const char* data, size_t size);
+
+  /**
+   * @brief Returns the number of datagrams waiting to be sent.
+   */
+  size_t Size();
+
+  /**
+   * @brief Sends all the collected datagrams and empties the batch.
+   *
+   * @param failed_tags If not nullptr, receives the tag of each datagram which could not be sent.
+   * @return Returns the number of datagrams which could not be sent.
+   */
+  size_t Flush(std::vector<int32_t>* failed_tags = nullptr);
+};
+
+}  // namespace sony::olfactory_device
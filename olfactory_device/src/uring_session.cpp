@@ -0,0 +1,267 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "uring_session.h"
+#ifdef __linux__
+#include "osc_bundle.h"
+#include "serial_port.h"
+#include "uring_transport.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+namespace sony::olfactory_device {
+
+// Constructor
+UringSession::UringSession() {}
+
+// Destructor
+UringSession::~UringSession() {
+  if (state_) {
+    Close();
+  }
+}
+
+// Opens a UDP socket connected to the OSC port of the device
+static int OpenOscSocket(const char* ip) {
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(OSC_PORT);
+  if (inet_pton(AF_INET, ip, &address.sin_addr) != 1) {
+    std::cerr << "[UringSession] Invalid IP address: " << ip << std::endl;
+    return -1;
+  }
+  int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    std::cerr << "[UringSession] Failed to open UDP socket for: " << ip << " (" << strerror(errno) << ")"
+              << std::endl;
+    if (fd >= 0) {
+      close(fd);
+    }
+    return -1;
+  }
+  return fd;
+}
+
+bool UringSession::Open(const char* device_id) {
+  std::cout << "[UringSession] device_id: " << device_id << std::endl;
+  if (state_) {
+    Close();
+  }
+  if (!UringTransport::GetInstance().IsAvailable()) {
+    std::cerr << "[UringSession] io_uring is not available." << std::endl;
+    return false;
+  }
+
+  auto state = std::make_shared<State>();
+  state->serial = (device_id[0] == '/');
+  state->fd = state->serial ? OpenSerialPort(device_id, false) : OpenOscSocket(device_id);
+  if (state->fd < 0) {
+    return false;
+  }
+
+  device_id_ = device_id;
+  state_ = state;
+  Receive(state_);
+  return true;
+}
+
+void UringSession::Receive(const std::shared_ptr<State>& state) {
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->receiving = true;
+    state->pending++;
+  }
+  SubmitReceive(state);
+}
+
+void UringSession::SubmitReceive(const std::shared_ptr<State>& state) {
+  std::vector<std::unique_ptr<UringOperation>> operations;
+  operations.push_back(std::make_unique<UringOperation>());
+  UringOperation& operation = *operations.back();
+  operation.opcode = state->serial ? IORING_OP_READ : IORING_OP_RECV;
+  operation.fd = state->fd;
+  operation.buffer.resize(URING_RECV_BUFFER_SIZE);
+  operation.complete = [state](UringOperation& operation, int32_t result) {
+    bool again = false;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (result > 0) {
+        state->received.emplace_back(operation.buffer.data(), result);
+      }
+      // ICMP errors of earlier datagrams are reported to the next receive of a connected UDP socket
+      again = !state->closing && (result > 0 || result == -ECONNREFUSED || result == -EINTR);
+      if (again) {
+        // Close() must not cancel before the next receive is in the ring
+        state->rearming = true;
+      } else {
+        if (!state->closing) {
+          std::cerr << "[UringSession] Failed to receive data: " << strerror(-result) << std::endl;
+        }
+        state->receiving = false;
+        state->pending--;
+      }
+      state->changed.notify_all();
+    }
+    if (again) {
+      SubmitReceive(state);
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->rearming = false;
+      state->changed.notify_all();
+    }
+  };
+  UringTransport::GetInstance().Submit(operations);
+}
+
+bool UringSession::Write(std::vector<std::string>& data) {
+  std::shared_ptr<State> state = state_;
+  std::vector<std::unique_ptr<UringOperation>> operations;
+  for (auto& bytes : data) {
+    operations.push_back(std::make_unique<UringOperation>());
+    UringOperation& operation = *operations.back();
+    operation.opcode = state->serial ? IORING_OP_WRITE : IORING_OP_SEND;
+    operation.fd = state->fd;
+    operation.buffer.assign(bytes.begin(), bytes.end());
+    operation.complete = [state](UringOperation& operation, int32_t result) {
+      if (result < 0 || static_cast<size_t>(result) < operation.buffer.size()) {
+        std::cerr << "[UringSession] Failed to send data: "
+                  << (result < 0 ? strerror(-result) : "short write") << std::endl;
+      }
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->pending--;
+      state->changed.notify_all();
+    };
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->pending += static_cast<int32_t>(operations.size());
+  }
+  return UringTransport::GetInstance().Submit(operations);
+}
+
+void UringSession::Close() {
+  if (!state_) {
+    return;
+  }
+  std::shared_ptr<State> state = std::move(state_);
+
+  // Let the sends complete, then cancel the outstanding receive
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->closing = true;
+  state->changed.wait(lock, [&state]() {
+    return state->pending == (state->receiving ? 1 : 0) && !state->rearming;
+  });
+  if (state->receiving) {
+    lock.unlock();
+    std::vector<std::unique_ptr<UringOperation>> operations;
+    operations.push_back(std::make_unique<UringOperation>());
+    operations.back()->opcode = IORING_OP_ASYNC_CANCEL;
+    operations.back()->fd = state->fd;
+    UringTransport::GetInstance().Submit(operations);
+    lock.lock();
+    state->changed.wait(lock, [&state]() { return state->pending == 0; });
+  }
+  close(state->fd);
+  state->fd = -1;
+  std::cout << "[UringSession] Connection closed: " << device_id_ << std::endl;
+}
+
+bool UringSession::IsConnected() const {
+  return state_ != nullptr;
+}
+
+bool UringSession::SendData(const DeviceCommand& command) {
+  return SendDataBatch({command});
+}
+
+bool UringSession::SendDataBatch(const std::vector<DeviceCommand>& commands) {
+  return Send(commands, OSC_TIMETAG_IMMEDIATE);
+}
+
+bool UringSession::SupportsTimeTags() const {
+  return state_ && !state_->serial;
+}
+
+bool UringSession::SendDataAt(const std::vector<DeviceCommand>& commands,
+                              std::chrono::steady_clock::time_point time) {
+  return Send(commands, ToOscTimeTag(time));
+}
+
+bool UringSession::Send(const std::vector<DeviceCommand>& commands, uint64_t time_tag) {
+  if (!state_) {
+    std::cerr << "[UringSession] Not connected." << std::endl;
+    return false;
+  }
+
+  // Same wire formats as UartSession and OscSession
+  std::vector<std::string> data;
+  if (state_->serial) {
+    std::string text;
+    char buffer[64] = {0};
+    for (const auto& command : commands) {
+      int length = FormatCommand(command, buffer, sizeof(buffer));
+      text.append(buffer, length);
+    }
+    data.push_back(std::move(text));
+  } else {
+    EncodeOscBundles(
+        commands, [&data](const char* bytes, size_t size) { data.emplace_back(bytes, size); }, time_tag);
+  }
+
+  spdlog::debug("[UringSession] Data sent: {} command(s) to {}", commands.size(), device_id_);
+  return Write(data);
+}
+
+bool UringSession::RecvData(std::string& data) {
+  std::shared_ptr<State> state = state_;
+  if (!state) {
+    std::cerr << "[UringSession] Not connected." << std::endl;
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->changed.wait(lock, [&state]() { return !state->received.empty() || !state->receiving; });
+  if (state->received.empty()) {
+    return false;
+  }
+  data = std::move(state->received.front());
+  state->received.pop_front();
+  return true;
+}
+
+bool UringSession::IsScentEmissionAvailable() {
+  if (!state_) {
+    std::cerr << "[UringSession] Not connected." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
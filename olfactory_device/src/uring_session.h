@@ -0,0 +1,152 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#ifdef __linux__
+#include "device_session_if.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+
+#define URING_RECV_BUFFER_SIZE (2048)  // Room for one received datagram or one read from a serial port
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief UringSession class implements the DeviceSessionIF interface on top of io_uring (Linux only).
+ *
+ * A device id which starts with '/' is opened as a serial port (e.g., /dev/ttyUSB0) and receives the
+ * commands as ASCII text like UartSession. Any other device id is an IP address which receives the
+ * commands as OSC bundles over UDP like OscSession.
+ *
+ * Sends are submitted to the process-wide UringTransport and return without waiting for the kernel to
+ * complete them, so one thread can drive many devices. Send errors are reported by the completion thread.
+ * Each session keeps one receive outstanding, whose data is handed out by RecvData().
+ */
+class UringSession : public DeviceSessionIF {
+ private:
+  // State shared with the operations in flight, which may complete after the session is gone
+  struct State {
+    std::mutex mutex;                  // Protects the members below
+    std::condition_variable changed;   // Notified when data is received or an operation completes
+    int fd = -1;                       // Socket or serial port
+    bool serial = false;               // The device is a serial port
+    bool closing = false;              // Close() was called, no new receive is started
+    bool receiving = false;            // A receive is outstanding
+    bool rearming = false;             // The completion of a receive is submitting the next one
+    int32_t pending = 0;               // Operations in flight
+    std::deque<std::string> received;  // Data received and not yet returned by RecvData()
+  };
+
+  std::string device_id_;             // Device id passed to Open()
+  std::shared_ptr<State> state_;      // nullptr while the session is closed
+
+  // Starts a receive, the completion starts the next one
+  static void Receive(const std::shared_ptr<State>& state);
+  static void SubmitReceive(const std::shared_ptr<State>& state);
+  // Submits writes of the given data, one operation each
+  bool Write(std::vector<std::string>& data);
+  // Encodes the commands in the wire format of the device and submits them
+  bool Send(const std::vector<DeviceCommand>& commands, uint64_t time_tag);
+
+ public:
+  UringSession();
+  ~UringSession() override;
+
+  /**
+   * @brief Opens a session with the specified device.
+   *
+   * @param device_id The path of a serial port, or the IP address of an OSC device.
+   * @return Returns true if the connection was successfully established, false otherwise.
+   */
+  bool Open(const char* device_id) override;
+
+  /**
+   * @brief Closes the session.
+   *
+   * Cancels the outstanding receive and waits for all the operations in flight to complete.
+   */
+  void Close() override;
+
+  /**
+   * @brief Checks if the session is connected.
+   *
+   * @return Returns true if the session is connected, false otherwise.
+   */
+  bool IsConnected() const override;
+
+  /**
+   * @brief Submits a command to the device.
+   *
+   * @param command The command to send.
+   * @return Returns true if the command was submitted, false otherwise.
+   */
+  bool SendData(const DeviceCommand& command) override;
+
+  /**
+   * @brief Submits several commands to the device with a single system call.
+   *
+   * @param commands The commands to send, in order.
+   * @return Returns true if the commands were submitted, false otherwise.
+   */
+  bool SendDataBatch(const std::vector<DeviceCommand>& commands) override;
+
+  /**
+   * @brief Checks if the session can send commands executed at a given time.
+   *
+   * @return Returns true for OSC devices, whose bundles carry the execution time as their time tag.
+   */
+  bool SupportsTimeTags() const override;
+
+  /**
+   * @brief Submits several commands in OSC bundles time-tagged with their execution time.
+   *
+   * Serial devices have no time tags and receive the commands immediately.
+   *
+   * @param commands The commands to send, in order.
+   * @param time The time at which the device executes the commands.
+   * @return Returns true if the commands were submitted, false otherwise.
+   */
+  bool SendDataAt(const std::vector<DeviceCommand>& commands,
+                  std::chrono::steady_clock::time_point time) override;
+
+  /**
+   * @brief Receives data from the device.
+   *
+   * Waits until the outstanding receive has completed with data.
+   *
+   * @param data Receives the data.
+   * @return Returns true if data was received, false if the session is closed or the receive failed.
+   */
+  bool RecvData(std::string& data) override;
+
+  /**
+   * @brief Check if scent emission is available for the specified device.
+   *
+   * @return Returns true if the availability check is performed successfully, otherwise false.
+   */
+  bool IsScentEmissionAvailable() override;
+};
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
@@ -0,0 +1,242 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "uring_transport.h"
+#ifdef __linux__
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace sony::olfactory_device {
+
+UringTransport& UringTransport::GetInstance() {
+  static UringTransport instance;
+  return instance;
+}
+
+UringTransport::UringTransport()
+    : ring_fd_(-1),
+      sq_ring_(MAP_FAILED),
+      sq_ring_size_(0),
+      cq_ring_(MAP_FAILED),
+      cq_ring_size_(0),
+      sqes_(static_cast<io_uring_sqe*>(MAP_FAILED)),
+      sqes_size_(0),
+      stop_(false) {
+  io_uring_params params = {};
+  ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, URING_QUEUE_DEPTH, &params));
+  if (ring_fd_ < 0) {
+    std::cerr << "[UringTransport] Failed to set up io_uring: " << strerror(errno) << std::endl;
+    return;
+  }
+
+  // Map the rings, which are a single mapping on recent kernels
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  if (sq_ring_ != MAP_FAILED) {
+    cq_ring_ = single_mmap ? sq_ring_
+                           : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ring_fd_, IORING_OFF_CQ_RING);
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    std::cerr << "[UringTransport] Failed to map io_uring: " << strerror(errno) << std::endl;
+    Release();
+    return;
+  }
+
+  char* sq = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  sq_entries_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_entries);
+  sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  char* cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  thread_ = std::thread(&UringTransport::Run, this);
+}
+
+UringTransport::~UringTransport() {
+  if (thread_.joinable()) {
+    // Wake the completion thread with an operation which completes at once
+    stop_ = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      io_uring_sqe* sqe = NextEntry();
+      if (sqe == nullptr) {
+        // The ring is unusable, leave the completion thread behind
+        thread_.detach();
+        return;
+      }
+      sqe->opcode = IORING_OP_NOP;
+      sqe->user_data = 0;
+      Enter();
+    }
+    thread_.join();
+  }
+  Release();
+}
+
+void UringTransport::Release() {
+  if (sqes_ != MAP_FAILED) {
+    munmap(sqes_, sqes_size_);
+    sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  }
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  cq_ring_ = MAP_FAILED;
+  if (sq_ring_ != MAP_FAILED) {
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = MAP_FAILED;
+  }
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+io_uring_sqe* UringTransport::NextEntry() {
+  uint32_t tail = *sq_tail_;
+  if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_) {
+    // Without SQPOLL the kernel consumes all the queued entries in io_uring_enter()
+    Enter();
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_) {
+      return nullptr;
+    }
+  }
+  uint32_t index = tail & sq_mask_;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  return sqe;
+}
+
+bool UringTransport::Enter() {
+  while (true) {
+    uint32_t queued = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (queued == 0) {
+      return true;
+    }
+    int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, queued, 0, 0, nullptr, 0));
+    if (ret >= 0) {
+      continue;
+    }
+    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+      // Wait for the completion thread to make room in the completion queue
+      std::this_thread::yield();
+      continue;
+    }
+    std::cerr << "[UringTransport] Failed to submit to io_uring: " << strerror(errno) << std::endl;
+    return false;
+  }
+}
+
+bool UringTransport::Submit(std::vector<std::unique_ptr<UringOperation>>& operations) {
+  std::vector<std::unique_ptr<UringOperation>> failed;
+  bool submitted = IsAvailable();
+  if (submitted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& operation : operations) {
+      io_uring_sqe* sqe = NextEntry();
+      if (sqe == nullptr) {
+        failed.push_back(std::move(operation));
+        continue;
+      }
+      sqe->opcode = operation->opcode;
+      sqe->fd = operation->fd;
+      if (operation->opcode == IORING_OP_ASYNC_CANCEL) {
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+      } else {
+        sqe->addr = reinterpret_cast<uint64_t>(operation->buffer.data());
+        sqe->len = static_cast<uint32_t>(operation->buffer.size());
+      }
+      if (operation->opcode == IORING_OP_READ || operation->opcode == IORING_OP_WRITE) {
+        // Read and write on the current position, which is what streams such as serial ports expect
+        sqe->off = static_cast<uint64_t>(-1);
+      }
+      // The operation is released by the completion thread
+      sqe->user_data = reinterpret_cast<uint64_t>(operation.release());
+    }
+    submitted = Enter() && failed.empty();
+  } else {
+    failed = std::move(operations);
+  }
+  operations.clear();
+
+  // Complete the operations which did not get an entry outside of the lock, they may submit again
+  for (auto& operation : failed) {
+    if (operation->complete) {
+      operation->complete(*operation, -EBUSY);
+    }
+  }
+  return submitted;
+}
+
+void UringTransport::Run() {
+  std::vector<std::pair<uint64_t, int32_t>> completions;
+  while (true) {
+    uint32_t head = *cq_head_;
+    uint32_t tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      if (stop_) {
+        break;
+      }
+      syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      continue;
+    }
+
+    // Release the entries before handling them, the complete functions may submit new operations
+    completions.clear();
+    for (; head != tail; head++) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      completions.emplace_back(cqe.user_data, cqe.res);
+    }
+    __atomic_store_n(cq_head_, tail, __ATOMIC_RELEASE);
+
+    for (const auto& completion : completions) {
+      std::unique_ptr<UringOperation> operation(reinterpret_cast<UringOperation*>(completion.first));
+      if (operation && operation->complete) {
+        operation->complete(*operation, completion.second);
+      }
+    }
+  }
+}
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
@@ -0,0 +1,120 @@
+/**
+ * Sony CONFIDENTIAL
+ *
+ * Copyright 2024 Sony Group Corporation
+ *
+ * DO NOT COPY AND/OR REDISTRIBUTE WITHOUT PERMISSION.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#pragma once
+#ifdef __linux__
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#include <linux/io_uring.h>
+
+#define URING_QUEUE_DEPTH (256)  // Submission queue entries, the completion queue is twice as large
+
+namespace sony::olfactory_device {
+
+/**
+ * @brief UringOperation is one I/O request handed to UringTransport.
+ *
+ * The transport owns the operation from Submit() until its completion has been handled, so the buffer
+ * stays valid for the kernel in the meantime.
+ */
+struct UringOperation {
+  uint8_t opcode;                          // IORING_OP_SEND, IORING_OP_RECV, IORING_OP_READ, ...
+  int fd;                                  // File descriptor the operation applies to
+  std::vector<char> buffer;                // Data to write, or room for the data to read
+  std::function<void(UringOperation& operation, int32_t result)> complete;  // Called on completion
+};
+
+/**
+ * @brief UringTransport runs one io_uring shared by all the UringSession objects of the process.
+ *
+ * Submit() queues operations and hands them to the kernel with a single io_uring_enter() call, without
+ * waiting for them to complete. A dedicated completion thread reaps the completions in batches and calls
+ * the complete function of each operation, then releases it. The complete functions run on the
+ * completion thread and may submit new operations.
+ */
+class UringTransport {
+ private:
+  int ring_fd_;                       // io_uring file descriptor, -1 if the ring could not be set up
+  void* sq_ring_;                     // Mapped submission queue ring
+  size_t sq_ring_size_;
+  void* cq_ring_;                     // Mapped completion queue ring, may share the submission mapping
+  size_t cq_ring_size_;
+  io_uring_sqe* sqes_;                // Mapped submission queue entries
+  size_t sqes_size_;
+
+  // Fields of the mapped rings, head and tail are shared with the kernel
+  uint32_t* sq_head_;
+  uint32_t* sq_tail_;
+  uint32_t sq_mask_;
+  uint32_t sq_entries_;
+  uint32_t* sq_array_;
+  uint32_t* cq_head_;
+  uint32_t* cq_tail_;
+  uint32_t cq_mask_;
+  io_uring_cqe* cqes_;
+
+  std::mutex mutex_;                  // Serializes the submissions
+  std::thread thread_;                // Completion thread
+  std::atomic<bool> stop_;            // Completion thread must exit
+
+  UringTransport();
+  ~UringTransport();
+
+  void Release();
+  // Returns a cleared submission entry, handing the queued ones to the kernel first if the ring is full.
+  // Returns nullptr if the ring stays full.
+  io_uring_sqe* NextEntry();
+  // Hands all the queued entries to the kernel
+  bool Enter();
+  void Run();
+
+ public:
+  /**
+   * @brief Returns the process-wide transport.
+   */
+  static UringTransport& GetInstance();
+
+  /**
+   * @brief Checks if io_uring could be set up on this system.
+   */
+  bool IsAvailable() const { return ring_fd_ >= 0; }
+
+  /**
+   * @brief Submits operations to the kernel with one system call.
+   *
+   * An IORING_OP_ASYNC_CANCEL operation cancels all the operations in flight on its file descriptor.
+   *
+   * @param operations The operations to submit. The transport takes ownership of all of them and calls
+   *        the complete function of each exactly once, with a negative errno value if it failed.
+   * @return Returns true if the kernel accepted all the operations, false otherwise. Operations which
+   *         did not fit in the ring are completed at once with -EBUSY, those already in the ring are
+   *         handed to the kernel by the next submission.
+   */
+  bool Submit(std::vector<std::unique_ptr<UringOperation>>& operations);
+};
+
+}  // namespace sony::olfactory_device
+#endif  // __linux__
@@ -42,6 +42,13 @@ void UnloadRuntimeLibrary();
  */
 OdResult RegisterLogCallback(OdLogCallback callback);
 
+/**
+ * @brief Load (or reload) the device configuration.
+ * @param[in] json_path The path of device.json to load, or nullptr to load the installed device.json
+ * @return OdResult Returns SUCCESS if the configuration is loaded successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult LoadDeviceConfig(const char* json_path);
+
 /**
  * @brief Start a session for the specified device.
  * @param[in] device_id The UART port number (e.g., "COM3") representing the device
@@ -94,4 +101,259 @@ OdResult StopScentEmission(const char* device_id);
  */
 OdResult IsScentEmissionAvailable(const char* device_id, bool& is_available);
 
+/**
+ * @brief Get the handle of the specified device.
+ * @param[in] device_id The device id written in device.json
+ * @param[out] handle The handle of the device
+ * @return OdResult Returns SUCCESS if the device is found, otherwise ERROR_UNKNOWN
+ */
+OdResult GetDeviceHandle(const char* device_id, int32_t& handle);
+
+/**
+ * @brief Start a session for the device of the specified handle.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @return OdResult Returns SUCCESS if the session starts successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult StartSessionByHandle(int32_t handle);
+
+/**
+ * @brief End the session for the device of the specified handle.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @return OdResult Returns SUCCESS if the session ends successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult EndSessionByHandle(int32_t handle);
+
+/**
+ * @brief Start scent emission for the device of the specified handle.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @param[in] scent The number of the scent to emit
+ * @param[in] duration The duration of emission
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false otherwise
+ * @return OdResult Returns SUCCESS if the scent emission starts successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult StartScentEmissionByHandle(int32_t handle, int32_t scent, float duration, bool& is_available);
+
+/**
+ * @brief Stop scent emission for the device of the specified handle.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @return OdResult Returns SUCCESS if the scent emission stops successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult StopScentEmissionByHandle(int32_t handle);
+
+/**
+ * @brief Check if scent emission is available for the device of the specified handle.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false otherwise
+ * @return OdResult Returns SUCCESS if the availability check is performed successfully, otherwise
+ * ERROR_UNKNOWN
+ */
+OdResult IsScentEmissionAvailableByHandle(int32_t handle, bool& is_available);
+
+/**
+ * @brief Wait until scent emission becomes available for the specified device.
+ * @param[in] device_id The UART port number (e.g., "COM3") representing the device
+ * @param[in] timeout_ms The maximum time to wait in milliseconds, or a negative value to wait without limit
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false on timeout
+ * @return OdResult Returns SUCCESS if the wait completes or times out, otherwise ERROR_UNKNOWN
+ */
+OdResult WaitScentEmissionAvailable(const char* device_id, int32_t timeout_ms, bool& is_available);
+
+/**
+ * @brief Wait until scent emission becomes available for the device of the specified handle.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @param[in] timeout_ms The maximum time to wait in milliseconds, or a negative value to wait without limit
+ * @param[out] is_available A boolean flag set to true if scent emission is available, false on timeout
+ * @return OdResult Returns SUCCESS if the wait completes or times out, otherwise ERROR_UNKNOWN
+ */
+OdResult WaitScentEmissionAvailableByHandle(int32_t handle, int32_t timeout_ms, bool& is_available);
+
+/**
+ * @brief Register a callback called when scent emission becomes available again after a cooldown.
+ * @param[in] callback The callback function, or nullptr to unregister. It is called on an internal thread.
+ * @param[in] user_data A pointer passed to the callback as is
+ * @return OdResult Returns SUCCESS if the callback is registered successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult RegisterAvailabilityCallback(OdAvailabilityCallback callback, void* user_data);
+
+/**
+ * @brief Get the remaining emission and cooldown time of each scent of the specified device.
+ * @param[in] device_id The UART port number (e.g., "COM3") representing the device
+ * @param[out] times The array filled with the times of the scents, may be nullptr if capacity is 0
+ * @param[in] capacity The number of elements of times
+ * @param[out] count The number of scents of the device. Only the first capacity scents are written.
+ * @return OdResult Returns SUCCESS if the times are read successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult GetScentEmissionTimes(const char* device_id, OdScentTime* times, int32_t capacity, int32_t& count);
+
+/**
+ * @brief Get the remaining emission and cooldown time of each scent of the device of the specified handle.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @param[out] times The array filled with the times of the scents, may be nullptr if capacity is 0
+ * @param[in] capacity The number of elements of times
+ * @param[out] count The number of scents of the device. Only the first capacity scents are written.
+ * @return OdResult Returns SUCCESS if the times are read successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult GetScentEmissionTimesByHandle(int32_t handle, OdScentTime* times, int32_t capacity, int32_t& count);
+
+/**
+ * @brief Register a log callback function called from a background thread.
+ *
+ * Messages are dropped when the internal buffer is full. Call this function with nullptr before
+ * unloading the library.
+ *
+ * @param[in] callback The callback function to be called with log messages and their levels, or nullptr
+ * to stop the background thread
+ * @param[in] level The lowest level to log. Messages below it are discarded before being formatted.
+ * @return OdResult Returns SUCCESS if the callback is registered successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult RegisterAsyncLogCallback(OdLogCallback callback, OdLogLevel level);
+
+/**
+ * @brief Get the latency statistics of the API calls and the counters of the library.
+ * @param[out] stats The statistics since the library was loaded or since the last reset
+ * @param[in] reset True to start the next statistics from now
+ * @return OdResult Returns SUCCESS if the statistics are read successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult GetStats(OdStats& stats, bool reset);
+
+/**
+ * @brief Start the sessions of several devices concurrently.
+ * @param[in] device_ids The ids of the devices
+ * @param[in] count The number of devices
+ * @param[in] parallelism The maximum number of devices processed at the same time, 0 for the default (16)
+ * @param[out] results The result of each device, may be nullptr
+ * @return OdResult Returns SUCCESS if all the sessions start successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult StartSessions(const char* const* device_ids, int32_t count, int32_t parallelism, OdResult* results);
+
+/**
+ * @brief End the sessions of several devices concurrently.
+ * @param[in] device_ids The ids of the devices
+ * @param[in] count The number of devices
+ * @param[in] parallelism The maximum number of devices processed at the same time, 0 for the default (16)
+ * @param[out] results The result of each device, may be nullptr
+ * @return OdResult Returns SUCCESS if all the sessions end successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult EndSessions(const char* const* device_ids, int32_t count, int32_t parallelism, OdResult* results);
+
+/**
+ * @brief Start scent emissions on several devices in one call.
+ * @param[in] emissions The emissions to start
+ * @param[in] count The number of emissions
+ * @param[in] parallelism The maximum number of devices sent to at the same time, 0 for the default (1)
+ * @param[out] is_available The array set to true for each emission which was sent, false otherwise
+ * @param[out] results The array set to the result of each emission. A rejected emission is a SUCCESS.
+ * @return OdResult Returns SUCCESS if every emission has a SUCCESS result, otherwise ERROR_UNKNOWN
+ */
+OdResult StartScentEmissions(const OdScentEmission* emissions, int32_t count, int32_t parallelism,
+                            bool* is_available, OdResult* results);
+
+/**
+ * @brief Get the current time of the clock used by the scheduled emissions.
+ * @param[out] time_us The current time in microseconds, on a monotonic clock with an unspecified origin
+ * @return OdResult Returns SUCCESS
+ */
+OdResult GetTime(int64_t& time_us);
+
+/**
+ * @brief Schedule a scent emission for the specified device at a future time.
+ * @param[in] device_id The UART port number (e.g., "COM3") representing the device
+ * @param[in] scent_name The name of the scent to emit
+ * @param[in] duration The duration of emission
+ * @param[in] time_us The time of the emission in microseconds, on the clock of GetTime
+ * @param[out] is_available A boolean flag set to true if the emission is scheduled, false if the scent is
+ * unavailable at that time
+ * @return OdResult Returns SUCCESS if the request is handled successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult ScheduleScentEmission(const char* device_id, const char* scent_name, float duration, int64_t time_us,
+                               bool& is_available);
+
+/**
+ * @brief Schedule a scent emission for the device of the specified handle at a future time.
+ * @param[in] handle The handle returned by GetDeviceHandle
+ * @param[in] scent The number of the scent to emit
+ * @param[in] duration The duration of emission
+ * @param[in] time_us The time of the emission in microseconds, on the clock of GetTime
+ * @param[out] is_available A boolean flag set to true if the emission is scheduled, false if the scent is
+ * unavailable at that time
+ * @return OdResult Returns SUCCESS if the request is handled successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult ScheduleScentEmissionByHandle(int32_t handle, int32_t scent, float duration, int64_t time_us,
+                                       bool& is_available);
+
+/**
+ * @brief Start scent emissions on several devices at the same instant.
+ * @param[in] emissions The emissions to start
+ * @param[in] count The number of emissions
+ * @param[out] is_available The array set to true for each emission which was sent
+ * @param[out] results The array set to the result of each emission. A rejected emission is a SUCCESS.
+ * @param[out] group The start time and the measured skew of the released devices
+ * @return OdResult Returns SUCCESS if every emission has a SUCCESS result, otherwise ERROR_UNKNOWN
+ */
+OdResult StartGroupScentEmission(const OdScentEmission* emissions, int32_t count, bool* is_available,
+                                 OdResult* results, OdGroupEmission& group);
+
+/**
+ * @brief Register a callback called when a scent emission ends after its duration.
+ * @param[in] callback The callback function, or nullptr to unregister. It is called on an internal thread.
+ * @param[in] user_data A pointer passed to the callback as is
+ * @return OdResult Returns SUCCESS if the callback is registered successfully, otherwise ERROR_UNKNOWN
+ */
+OdResult RegisterEmissionEndCallback(OdEmissionEndCallback callback, void* user_data);
+
+/**
+ * @brief Write a timeline file, played by OpenTimeline.
+ * @param[in] path The path of the file
+ * @param[in] events The emissions of the timeline
+ * @param[in] count The number of events
+ * @return OdResult Returns SUCCESS if the file is written, otherwise ERROR_UNKNOWN
+ */
+OdResult WriteTimeline(const char* path, const OdTimelineEvent* events, int32_t count);
+
+/**
+ * @brief Open a timeline file written by WriteTimeline, paused at its start.
+ * @param[in] path The path of the file
+ * @param[out] timeline The id of the opened timeline
+ * @return OdResult Returns SUCCESS if the timeline is opened, otherwise ERROR_UNKNOWN
+ */
+OdResult OpenTimeline(const char* path, int32_t& timeline);
+
+/**
+ * @brief Play a timeline from its position, from its start if it reached its end.
+ * @param[in] timeline The id returned by OpenTimeline
+ * @return OdResult Returns SUCCESS if the timeline is playing, otherwise ERROR_UNKNOWN
+ */
+OdResult PlayTimeline(int32_t timeline);
+
+/**
+ * @brief Pause a timeline at its position.
+ * @param[in] timeline The id returned by OpenTimeline
+ * @return OdResult Returns SUCCESS if the timeline is paused, otherwise ERROR_UNKNOWN
+ */
+OdResult PauseTimeline(int32_t timeline);
+
+/**
+ * @brief Move the position of a timeline, playing or paused.
+ * @param[in] timeline The id returned by OpenTimeline
+ * @param[in] position_us The new position in microseconds from the start of the timeline
+ * @return OdResult Returns SUCCESS if the position is moved, otherwise ERROR_UNKNOWN
+ */
+OdResult SeekTimeline(int32_t timeline, int64_t position_us);
+
+/**
+ * @brief Get the position of a timeline.
+ * @param[in] timeline The id returned by OpenTimeline
+ * @param[out] position_us The position in microseconds from the start of the timeline
+ * @param[out] is_playing A boolean flag set to true while the timeline plays
+ * @return OdResult Returns SUCCESS if the position is read, otherwise ERROR_UNKNOWN
+ */
+OdResult GetTimelinePosition(int32_t timeline, int64_t& position_us, bool& is_playing);
+
+/**
+ * @brief Stop a timeline and unmap its file.
+ * @param[in] timeline The id returned by OpenTimeline
+ * @return OdResult Returns SUCCESS if the timeline is closed, otherwise ERROR_UNKNOWN
+ */
+OdResult CloseTimeline(int32_t timeline);
+
 }  // namespace sony::olfactory_device
@@ -48,12 +48,42 @@ bool IsRuntimeLibraryValid() { return handle != nullptr; }
   name##_t name = nullptr;
 
 DLL_FUNC_DEFINE(sony_odRegisterLogCallback, OdLogCallback)
+DLL_FUNC_DEFINE(sony_odLoadDeviceConfig, const char*)
 DLL_FUNC_DEFINE(sony_odStartSession, const char*)
 DLL_FUNC_DEFINE(sony_odEndSession, const char*)
 DLL_FUNC_DEFINE(sony_odSetScentOrientation, const char*, float, float)
 DLL_FUNC_DEFINE(sony_odStartScentEmission, const char*, const char*, float, bool&)
 DLL_FUNC_DEFINE(sony_odStopScentEmission, const char*)
 DLL_FUNC_DEFINE(sony_odIsScentEmissionAvailable, const char*, bool&)
+DLL_FUNC_DEFINE(sony_odGetDeviceHandle, const char*, int32_t&)
+DLL_FUNC_DEFINE(sony_odStartSessionByHandle, int32_t)
+DLL_FUNC_DEFINE(sony_odEndSessionByHandle, int32_t)
+DLL_FUNC_DEFINE(sony_odStartScentEmissionByHandle, int32_t, int32_t, float, bool&)
+DLL_FUNC_DEFINE(sony_odStopScentEmissionByHandle, int32_t)
+DLL_FUNC_DEFINE(sony_odIsScentEmissionAvailableByHandle, int32_t, bool&)
+DLL_FUNC_DEFINE(sony_odWaitScentEmissionAvailable, const char*, int32_t, bool&)
+DLL_FUNC_DEFINE(sony_odWaitScentEmissionAvailableByHandle, int32_t, int32_t, bool&)
+DLL_FUNC_DEFINE(sony_odRegisterAvailabilityCallback, OdAvailabilityCallback, void*)
+DLL_FUNC_DEFINE(sony_odGetScentEmissionTimes, const char*, OdScentTime*, int32_t, int32_t&)
+DLL_FUNC_DEFINE(sony_odGetScentEmissionTimesByHandle, int32_t, OdScentTime*, int32_t, int32_t&)
+DLL_FUNC_DEFINE(sony_odRegisterAsyncLogCallback, OdLogCallback, OdLogLevel)
+DLL_FUNC_DEFINE(sony_odGetStats, OdStats&, bool)
+DLL_FUNC_DEFINE(sony_odStartSessions, const char* const*, int32_t, int32_t, OdResult*)
+DLL_FUNC_DEFINE(sony_odEndSessions, const char* const*, int32_t, int32_t, OdResult*)
+DLL_FUNC_DEFINE(sony_odStartScentEmissions, const OdScentEmission*, int32_t, int32_t, bool*, OdResult*)
+DLL_FUNC_DEFINE(sony_odGetTime, int64_t&)
+DLL_FUNC_DEFINE(sony_odScheduleScentEmission, const char*, const char*, float, int64_t, bool&)
+DLL_FUNC_DEFINE(sony_odScheduleScentEmissionByHandle, int32_t, int32_t, float, int64_t, bool&)
+DLL_FUNC_DEFINE(sony_odRegisterEmissionEndCallback, OdEmissionEndCallback, void*)
+DLL_FUNC_DEFINE(sony_odWriteTimeline, const char*, const OdTimelineEvent*, int32_t)
+DLL_FUNC_DEFINE(sony_odOpenTimeline, const char*, int32_t&)
+DLL_FUNC_DEFINE(sony_odPlayTimeline, int32_t)
+DLL_FUNC_DEFINE(sony_odPauseTimeline, int32_t)
+DLL_FUNC_DEFINE(sony_odSeekTimeline, int32_t, int64_t)
+DLL_FUNC_DEFINE(sony_odGetTimelinePosition, int32_t, int64_t&, bool&)
+DLL_FUNC_DEFINE(sony_odCloseTimeline, int32_t)
+DLL_FUNC_DEFINE(sony_odStartGroupScentEmission, const OdScentEmission*, int32_t, bool*, OdResult*,
+                OdGroupEmission&)
 
 /** Get the installation path from a registry key */
 std::wstring GetInstallPath() {
@@ -114,12 +144,41 @@ OdResult LoadRuntimeLibrary() {
 #pragma warning(push)
 #pragma warning(disable : 4191)
   GET_FUNCTION(sony_odRegisterLogCallback);
+  GET_FUNCTION(sony_odLoadDeviceConfig);
   GET_FUNCTION(sony_odStartSession);
   GET_FUNCTION(sony_odEndSession);
   GET_FUNCTION(sony_odSetScentOrientation);
   GET_FUNCTION(sony_odStartScentEmission);
   GET_FUNCTION(sony_odStopScentEmission);
   GET_FUNCTION(sony_odIsScentEmissionAvailable);
+  GET_FUNCTION(sony_odGetDeviceHandle);
+  GET_FUNCTION(sony_odStartSessionByHandle);
+  GET_FUNCTION(sony_odEndSessionByHandle);
+  GET_FUNCTION(sony_odStartScentEmissionByHandle);
+  GET_FUNCTION(sony_odStopScentEmissionByHandle);
+  GET_FUNCTION(sony_odIsScentEmissionAvailableByHandle);
+  GET_FUNCTION(sony_odWaitScentEmissionAvailable);
+  GET_FUNCTION(sony_odWaitScentEmissionAvailableByHandle);
+  GET_FUNCTION(sony_odRegisterAvailabilityCallback);
+  GET_FUNCTION(sony_odGetScentEmissionTimes);
+  GET_FUNCTION(sony_odGetScentEmissionTimesByHandle);
+  GET_FUNCTION(sony_odRegisterAsyncLogCallback);
+  GET_FUNCTION(sony_odGetStats);
+  GET_FUNCTION(sony_odStartSessions);
+  GET_FUNCTION(sony_odEndSessions);
+  GET_FUNCTION(sony_odStartScentEmissions);
+  GET_FUNCTION(sony_odGetTime);
+  GET_FUNCTION(sony_odScheduleScentEmission);
+  GET_FUNCTION(sony_odScheduleScentEmissionByHandle);
+  GET_FUNCTION(sony_odStartGroupScentEmission);
+  GET_FUNCTION(sony_odRegisterEmissionEndCallback);
+  GET_FUNCTION(sony_odWriteTimeline);
+  GET_FUNCTION(sony_odOpenTimeline);
+  GET_FUNCTION(sony_odPlayTimeline);
+  GET_FUNCTION(sony_odPauseTimeline);
+  GET_FUNCTION(sony_odSeekTimeline);
+  GET_FUNCTION(sony_odGetTimelinePosition);
+  GET_FUNCTION(sony_odCloseTimeline);
 #pragma warning(pop)
 
 #undef GET_FUNCTION
@@ -144,6 +203,18 @@ OdResult RegisterLogCallback(OdLogCallback callback) {
   return sony_odRegisterLogCallback(callback);
 }
 
+OdResult LoadDeviceConfig(const char* json_path) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odLoadDeviceConfig == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odLoadDeviceConfig(json_path);
+}
+
 OdResult StartSession(const char* device_id) {
   if (!IsRuntimeLibraryValid()) {
     return OdResult::ERROR_LIBRARY_NOT_FOUND;
@@ -216,4 +287,344 @@ OdResult SetScentOrientation(const char* device_id, float yaw, float pitch) {
   return sony_odSetScentOrientation(device_id, yaw, pitch);
 }
 
+OdResult GetDeviceHandle(const char* device_id, int32_t& handle) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odGetDeviceHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odGetDeviceHandle(device_id, handle);
+}
+
+OdResult StartSessionByHandle(int32_t handle) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odStartSessionByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odStartSessionByHandle(handle);
+}
+
+OdResult EndSessionByHandle(int32_t handle) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odEndSessionByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odEndSessionByHandle(handle);
+}
+
+OdResult StartScentEmissionByHandle(int32_t handle, int32_t scent, float duration, bool& is_available) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odStartScentEmissionByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odStartScentEmissionByHandle(handle, scent, duration, is_available);
+}
+
+OdResult StopScentEmissionByHandle(int32_t handle) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odStopScentEmissionByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odStopScentEmissionByHandle(handle);
+}
+
+OdResult IsScentEmissionAvailableByHandle(int32_t handle, bool& is_available) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odIsScentEmissionAvailableByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odIsScentEmissionAvailableByHandle(handle, is_available);
+}
+
+OdResult WaitScentEmissionAvailable(const char* device_id, int32_t timeout_ms, bool& is_available) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odWaitScentEmissionAvailable == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odWaitScentEmissionAvailable(device_id, timeout_ms, is_available);
+}
+
+OdResult WaitScentEmissionAvailableByHandle(int32_t handle, int32_t timeout_ms, bool& is_available) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odWaitScentEmissionAvailableByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odWaitScentEmissionAvailableByHandle(handle, timeout_ms, is_available);
+}
+
+OdResult RegisterAvailabilityCallback(OdAvailabilityCallback callback, void* user_data) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odRegisterAvailabilityCallback == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odRegisterAvailabilityCallback(callback, user_data);
+}
+
+OdResult GetScentEmissionTimes(const char* device_id, OdScentTime* times, int32_t capacity, int32_t& count) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odGetScentEmissionTimes == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odGetScentEmissionTimes(device_id, times, capacity, count);
+}
+
+OdResult GetScentEmissionTimesByHandle(int32_t handle, OdScentTime* times, int32_t capacity, int32_t& count) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odGetScentEmissionTimesByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odGetScentEmissionTimesByHandle(handle, times, capacity, count);
+}
+
+OdResult RegisterAsyncLogCallback(OdLogCallback callback, OdLogLevel level) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odRegisterAsyncLogCallback == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odRegisterAsyncLogCallback(callback, level);
+}
+
+OdResult GetStats(OdStats& stats, bool reset) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odGetStats == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odGetStats(stats, reset);
+}
+
+OdResult StartSessions(const char* const* device_ids, int32_t count, int32_t parallelism, OdResult* results) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odStartSessions == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odStartSessions(device_ids, count, parallelism, results);
+}
+
+OdResult EndSessions(const char* const* device_ids, int32_t count, int32_t parallelism, OdResult* results) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odEndSessions == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odEndSessions(device_ids, count, parallelism, results);
+}
+
+OdResult StartScentEmissions(const OdScentEmission* emissions, int32_t count, int32_t parallelism,
+                            bool* is_available, OdResult* results) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odStartScentEmissions == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odStartScentEmissions(emissions, count, parallelism, is_available, results);
+}
+
+OdResult GetTime(int64_t& time_us) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odGetTime == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odGetTime(time_us);
+}
+
+OdResult ScheduleScentEmission(const char* device_id, const char* scent_name, float duration, int64_t time_us,
+                               bool& is_available) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odScheduleScentEmission == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odScheduleScentEmission(device_id, scent_name, duration, time_us, is_available);
+}
+
+OdResult ScheduleScentEmissionByHandle(int32_t handle, int32_t scent, float duration, int64_t time_us,
+                                       bool& is_available) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odScheduleScentEmissionByHandle == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odScheduleScentEmissionByHandle(handle, scent, duration, time_us, is_available);
+}
+
+OdResult StartGroupScentEmission(const OdScentEmission* emissions, int32_t count, bool* is_available,
+                                 OdResult* results, OdGroupEmission& group) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odStartGroupScentEmission == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odStartGroupScentEmission(emissions, count, is_available, results, group);
+}
+
+OdResult RegisterEmissionEndCallback(OdEmissionEndCallback callback, void* user_data) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odRegisterEmissionEndCallback == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odRegisterEmissionEndCallback(callback, user_data);
+}
+
+OdResult WriteTimeline(const char* path, const OdTimelineEvent* events, int32_t count) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odWriteTimeline == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odWriteTimeline(path, events, count);
+}
+
+OdResult OpenTimeline(const char* path, int32_t& timeline) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odOpenTimeline == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odOpenTimeline(path, timeline);
+}
+
+OdResult PlayTimeline(int32_t timeline) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odPlayTimeline == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odPlayTimeline(timeline);
+}
+
+OdResult PauseTimeline(int32_t timeline) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odPauseTimeline == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odPauseTimeline(timeline);
+}
+
+OdResult SeekTimeline(int32_t timeline, int64_t position_us) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odSeekTimeline == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odSeekTimeline(timeline, position_us);
+}
+
+OdResult GetTimelinePosition(int32_t timeline, int64_t& position_us, bool& is_playing) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odGetTimelinePosition == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odGetTimelinePosition(timeline, position_us, is_playing);
+}
+
+OdResult CloseTimeline(int32_t timeline) {
+  if (!IsRuntimeLibraryValid()) {
+    return OdResult::ERROR_LIBRARY_NOT_FOUND;
+  }
+
+  if (sony_odCloseTimeline == nullptr) {
+    return OdResult::ERROR_FUNCTION_UNSUPPORTED;
+  }
+
+  return sony_odCloseTimeline(timeline);
+}
+
 }  // namespace sony::olfactory_device
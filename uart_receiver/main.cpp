@@ -19,8 +19,13 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <string>
 #include <windows.h>
 
+#include "uart_protocol.h"
+using namespace sony::olfactory_device;
+
 int main() {
   // COM|[gJiMj
   HANDLE hSerial =
@@ -58,13 +63,57 @@ int main() {
   char szBuff[256] = {0};
   DWORD dwBytesRead = 0;
 
+  // oCivgȐ
+  bool binary = false;
+  std::string text;  // vgRvTeLXg
+  UartFrameDecoder decoder;
+  uint64_t errors = 0;
+  uint64_t lost = 0;
+
+  // oCit[fR[hĕ\
+  auto decode = [&](const char* data, size_t size) {
+    DeviceCommand command;
+    uint8_t sequence;
+    for (size_t i = 0; i < size; i++) {
+      if (decoder.Push(static_cast<uint8_t>(data[i]), command, sequence)) {
+        printf("Received: %s(%d,%d) seq=%u\n", GetCommandName(command.opcode), command.target, command.level,
+               static_cast<unsigned>(sequence));
+      }
+    }
+    if (decoder.Errors() != errors || decoder.Lost() != lost) {
+      errors = decoder.Errors();
+      lost = decoder.Lost();
+      printf("Rejected frames: %llu, lost frames: %llu\n", static_cast<unsigned long long>(errors),
+             static_cast<unsigned long long>(lost));
+    }
+  };
+
   // f[^M[v
   printf("Waiting for data...\n");
   while (true) {
     if (ReadFile(hSerial, szBuff, sizeof(szBuff) - 1, &dwBytesRead, NULL)) {
-      if (dwBytesRead > 0) {
+      if (dwBytesRead > 0 && binary) {
+        decode(szBuff, dwBytesRead);
+      } else if (dwBytesRead > 0) {
         szBuff[dwBytesRead] = '\0';  // NullI[
         printf("Received: %s\n", szBuff);
+
+        // oCivgR̗vɉAȍ~̃f[^oCit[ƂĎM
+        text.append(szBuff, dwBytesRead);
+        size_t request = text.find(UART_PROTOCOL_REQUEST);
+        if (request != std::string::npos) {
+          const char reply[] = UART_PROTOCOL_ACCEPTED "\n";
+          DWORD dwBytesWritten = 0;
+          WriteFile(hSerial, reply, sizeof(reply) - 1, &dwBytesWritten, NULL);
+          printf("Binary protocol accepted.\n");
+          binary = true;
+          request += strlen(UART_PROTOCOL_REQUEST);
+          decode(text.data() + request, text.size() - request);
+          text.clear();
+        } else if (text.size() > strlen(UART_PROTOCOL_REQUEST)) {
+          // ꂽvoł悤ɖc
+          text.erase(0, text.size() - strlen(UART_PROTOCOL_REQUEST));
+        }
       }
     } else {
       printf("Error reading from COM4.\n");
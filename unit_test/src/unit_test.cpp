@@ -21,18 +21,67 @@
 #include "gtest/gtest.h"
 #include "olfactory_device.h"
 #include "olfactory_device_defs.h"
+#include "async_log.h"
+#include "device_handle_table.h"
+#include "frame_receiver.h"
+#include "osc_session.h"
+#include "timeline_player.h"
+#include "timing_wheel.h"
+#include "uart_protocol.h"
+#include "uart_session.h"
+#include "uart_write_queue.h"
+#include "udp_transmit_batch.h"
+#include "uring_session.h"
 using namespace sony::olfactory_device;
 
 #include <stdio.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <atomic>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <random>
 
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#endif
+#ifdef __linux__
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
 
 namespace {
 
+// Counts the packets received on the loopback interface
+class LoopbackListener : public PacketListener {
+ public:
+  std::atomic<int> received{0};
+  std::atomic<uint64_t> time_tag{0};  // Time tag of the last bundle
+
+  void ProcessPacket(const char* data, int size, const IpEndpointName& /*remote_endpoint*/) override {
+    if (size >= 16 && memcmp(data, "#bundle", 8) == 0) {
+      uint64_t value = 0;
+      for (int i = 8; i < 16; i++) {
+        value = (value << 8) | static_cast<uint8_t>(data[i]);
+      }
+      time_tag = value;
+    }
+    received++;
+  }
+};
+
 class TestOlfactoryDevice : public ::testing::Test {
  protected:
   TestOlfactoryDevice() {}
@@ -216,4 +265,1656 @@ TEST_F(TestOlfactoryDevice, 06_osc_devcies) {
   }
 }
 
+// Test case to load device.json from the specified path
+TEST_F(TestOlfactoryDevice, 07_load_device_config) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "127.0.0.1", "scent0": 0, "scent1": 1, "motor": 0},)"
+            << R"({"id": "101", "ip": "127.0.0.1", "scent0": 2, "scent1": 3, "motor": 1}]})";
+  json_file.close();
+
+  OdResult result = sony_odLoadDeviceConfig(json_path);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odStartSession("100");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  result = sony_odEndSession("100");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // The id is not written in the loaded device.json
+  result = sony_odStartSession("0");
+  ASSERT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  result = sony_odLoadDeviceConfig("not_exist_device.json");
+  ASSERT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  // Restore the installed device.json for the other test cases
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+// Test case to send the commands through the socket opened in Open(), see BM_OscSendPersistentSocket for
+// the latency
+TEST_F(TestOlfactoryDevice, 08_osc_persistent_socket) {
+  LoopbackListener listener;
+  UdpListeningReceiveSocket receive_socket(IpEndpointName("127.0.0.1", OSC_PORT), &listener);
+  std::thread receive_thread([&receive_socket]() { receive_socket.Run(); });
+
+  OscSession session;
+  ASSERT_TRUE(session.Open("127.0.0.1"));
+  ASSERT_TRUE(session.SendData({CommandOpcode::RELEASE, 0, 0}));
+  ASSERT_TRUE(session.SendData({CommandOpcode::RELEASE, 1, 0}));
+  session.Close();
+  ASSERT_FALSE(session.SendData({CommandOpcode::RELEASE, 0, 0}));
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  receive_socket.AsynchronousBreak();
+  receive_thread.join();
+  EXPECT_EQ(listener.received, 2);
+}
+
+// Test case to send several commands in OSC bundles
+TEST_F(TestOlfactoryDevice, 09_osc_send_batch) {
+  LoopbackListener listener;
+  UdpListeningReceiveSocket receive_socket(IpEndpointName("127.0.0.1", OSC_PORT), &listener);
+  std::thread receive_thread([&receive_socket]() { receive_socket.Run(); });
+
+  OscSession session;
+  ASSERT_TRUE(session.Open("127.0.0.1"));
+
+  // Both commands are carried by one datagram
+  ASSERT_TRUE(session.SendDataBatch({{CommandOpcode::MOTOR, 0, 30}, {CommandOpcode::MOTOR, 1, 30}}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(listener.received, 1);
+
+  // 100 commands (36 bytes each in a bundle) do not fit in one datagram
+  listener.received = 0;
+  std::vector<DeviceCommand> vec(100, {CommandOpcode::RELEASE, 0, 0});
+  ASSERT_TRUE(session.SendDataBatch(vec));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(listener.received, 3);
+
+  session.Close();
+  receive_socket.AsynchronousBreak();
+  receive_thread.join();
+}
+
+// Test case to encode commands as ASCII text
+TEST_F(TestOlfactoryDevice, 10_format_command) {
+  char buffer[64] = {0};
+  int length = FormatCommand({CommandOpcode::RELEASE, 0, 3}, buffer, sizeof(buffer));
+  EXPECT_STREQ(buffer, "release(0, 3)");
+  EXPECT_EQ(length, 13);
+
+  FormatCommand({CommandOpcode::MOTOR, 1, 30}, buffer, sizeof(buffer));
+  EXPECT_STREQ(buffer, "motor(1, 30)");
+}
+
+// Test case to call the API for many devices from several threads
+TEST_F(TestOlfactoryDevice, 11_multithread_devices) {
+  const int max_devices = 32;
+  const int max_threads = 8;
+  const int max_loops = 50;
+
+  // Each device has its own address, so that every device has its own session
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)";
+  for (int i = 0; i < max_devices; i++) {
+    json_file << (i == 0 ? "" : ",") << R"({"id": ")" << (200 + i) << R"(", "ip": "10.0.0.)" << i
+              << R"(", "scent0": 0, "scent1": 1, "motor": 0})";
+  }
+  json_file << "]}";
+  json_file.close();
+
+  OdResult result = sony_odLoadDeviceConfig(json_path);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // Run the function on all the threads at once and count the calls which did not succeed
+  std::atomic<int> failures{0};
+  auto run_threads = [&](const std::function<void(int)>& function) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < max_threads; t++) {
+      threads.emplace_back(function, t);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  // Every thread starts every session; only the first start of each device opens it
+  run_threads([&](int /*t*/) {
+    for (int i = 0; i < max_devices; i++) {
+      if (sony_odStartSession(std::to_string(200 + i).c_str()) != OdResult::SUCCESS) {
+        failures++;
+      }
+    }
+  });
+  ASSERT_EQ(failures, 0);
+
+  auto start = std::chrono::steady_clock::now();
+  run_threads([&](int t) {
+    for (int loop = 0; loop < max_loops; loop++) {
+      for (int i = 0; i < max_devices; i++) {
+        // Each thread starts on a different device to spread the load
+        std::string device_id = std::to_string(200 + (i + t * 4) % max_devices);
+        bool b_is_available = false;
+        if (sony_odIsScentEmissionAvailable(device_id.c_str(), b_is_available) != OdResult::SUCCESS) {
+          failures++;
+        }
+        if (sony_odStartScentEmission(device_id.c_str(), (loop % 2) ? "1" : "0", 1.0f, b_is_available) !=
+            OdResult::SUCCESS) {
+          failures++;
+        }
+        if (sony_odStopScentEmission(device_id.c_str()) != OdResult::SUCCESS) {
+          failures++;
+        }
+      }
+    }
+  });
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end - start;
+  std::cout << "[unit_test] " << max_threads * max_loops * max_devices * 3 << " calls: " << elapsed_seconds.count()
+            << "seconds" << std::endl;
+  EXPECT_EQ(failures, 0);
+
+  run_threads([&](int t) {
+    for (int i = t; i < max_devices; i += max_threads) {
+      if (sony_odEndSession(std::to_string(200 + i).c_str()) != OdResult::SUCCESS) {
+        failures++;
+      }
+    }
+  });
+  EXPECT_EQ(failures, 0);
+
+  // The sessions have been removed
+  result = sony_odStopScentEmission("200");
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  // Restore the installed device.json for the other test cases
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+// Test case to control a device through its handle
+TEST_F(TestOlfactoryDevice, 12_device_handle) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "127.0.0.1", "scent0": 0, "scent1": 1, "motor": 0}]})";
+  json_file.close();
+
+  OdResult result = sony_odLoadDeviceConfig(json_path);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  int32_t handle = -1;
+  result = sony_odGetDeviceHandle("100", handle);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // The same id always gives the same handle
+  int32_t same_handle = -1;
+  result = sony_odGetDeviceHandle("100", same_handle);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_EQ(handle, same_handle);
+
+  result = sony_odStartSessionByHandle(handle);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  bool b_is_available = false;
+  result = sony_odIsScentEmissionAvailableByHandle(handle, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_TRUE(b_is_available);
+
+  result = sony_odStartScentEmissionByHandle(handle, 0, 1.0f, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // The string API and the handle API share the state of the device
+  result = sony_odIsScentEmissionAvailable("100", b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_FALSE(b_is_available);
+
+  // Scent names which are not numbers are rejected
+  result = sony_odStartScentEmission("100", "abc", 1.0f, b_is_available);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+  result = sony_odStartScentEmission("100", "1x", 1.0f, b_is_available);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+  result = sony_odScheduleScentEmission("100", "", 1.0f, 0, b_is_available);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  result = sony_odStopScentEmissionByHandle(handle);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  result = sony_odEndSessionByHandle(handle);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odStopScentEmissionByHandle(handle);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+  result = sony_odStartSessionByHandle(-1);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+  result = sony_odGetDeviceHandle("not_exist", handle);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  // Restore the installed device.json for the other test cases
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+
+// Counts the availability callbacks of the device passed as user_data, the cooldowns left by the other
+// test cases end at any time
+std::atomic<int> g_available_count{0};
+
+void CountAvailableCallback(const char* device_id, void* user_data) {
+  if (strcmp(device_id, static_cast<const char*>(user_data)) == 0) {
+    g_available_count++;
+  }
+}
+
+// Test case to wait for the end of the cooldown instead of polling
+TEST_F(TestOlfactoryDevice, 13_wait_scent_emission_available) {
+  static const char kDeviceId[] = "0";
+  OdResult result = sony_odRegisterAvailabilityCallback(CountAvailableCallback, const_cast<char*>(kDeviceId));
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odStartSession("0");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  bool b_is_available = false;
+  result = sony_odStartScentEmission("0", "0", 1.0f, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // The cooldown lasts longer than the timeout
+  result = sony_odWaitScentEmissionAvailable("0", 100, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_FALSE(b_is_available);
+  EXPECT_EQ(g_available_count, 0);
+
+  auto start = std::chrono::steady_clock::now();
+  result = sony_odWaitScentEmissionAvailable("0", 10000, b_is_available);
+  auto end = std::chrono::steady_clock::now();
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_TRUE(b_is_available);
+  std::chrono::duration<double> elapsed_seconds = end - start;
+  std::cout << "[unit_test] end - start: " << elapsed_seconds.count() << "seconds" << std::endl;
+
+  // The callback is called by the timer thread around the same time
+  for (int i = 0; i < 100 && g_available_count == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(g_available_count, 1);
+
+  // Ending the session releases the waiters
+  result = sony_odStartScentEmission("0", "0", 1.0f, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  std::thread waiter([&result, &b_is_available]() {
+    result = sony_odWaitScentEmissionAvailable("0", -1, b_is_available);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(sony_odEndSession("0"), OdResult::SUCCESS);
+  waiter.join();
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+  EXPECT_FALSE(b_is_available);
+
+  sony_odRegisterAvailabilityCallback(nullptr, nullptr);
+}
+
+
+// Test case to read the remaining emission and cooldown times
+TEST_F(TestOlfactoryDevice, 14_scent_emission_times) {
+  OdResult result = sony_odStartSession("0");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // The number of scents can be queried without a buffer
+  int32_t count = 0;
+  result = sony_odGetScentEmissionTimes("0", nullptr, 0, count);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  ASSERT_EQ(count, 2);
+
+  std::vector<OdScentTime> times(count);
+  result = sony_odGetScentEmissionTimes("0", times.data(), count, count);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  for (const OdScentTime& time : times) {
+    EXPECT_EQ(time.emission_remaining_ms, 0);
+    EXPECT_EQ(time.cooldown_remaining_ms, 0);
+  }
+
+  bool b_is_available = false;
+  result = sony_odStartScentEmission("0", "1", 2.0f, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odGetScentEmissionTimes("0", times.data(), count, count);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_EQ(times[0].scent, 0);
+  EXPECT_EQ(times[0].cooldown_remaining_ms, 0);
+  EXPECT_EQ(times[1].scent, 1);
+  EXPECT_GT(times[1].emission_remaining_ms, 1900);
+  EXPECT_LE(times[1].emission_remaining_ms, 2000);
+  EXPECT_EQ(times[1].cooldown_remaining_ms - times[1].emission_remaining_ms, 6000);
+
+  result = sony_odEndSession("0");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  result = sony_odGetScentEmissionTimes("0", times.data(), count, count);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+}
+
+
+// Test case to emit from a device with more than two channels
+TEST_F(TestOlfactoryDevice, 15_multi_channel_device) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "200", "ip": "127.0.0.1", "channels": [0, 1, 2, 3, 4],)"
+            << R"( "cooldown": [0.5, 0.5, 0.5, 0.5, 1.0], "motor": 0}]})";
+  json_file.close();
+
+  OdResult result = sony_odLoadDeviceConfig(json_path);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odStartSession("200");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  bool b_is_available = false;
+  result = sony_odStartScentEmission("200", "4", 0.0f, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  result = sony_odStartScentEmission("200", "5", 0.0f, b_is_available);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  // Only the emitted channel cools down, for its own cooldown
+  OdScentTime times[8] = {};
+  int32_t count = 0;
+  result = sony_odGetScentEmissionTimes("200", times, 8, count);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  ASSERT_EQ(count, 5);
+  for (int32_t i = 0; i < 4; i++) {
+    EXPECT_EQ(times[i].cooldown_remaining_ms, 0);
+  }
+  EXPECT_GT(times[4].cooldown_remaining_ms, 900);
+  EXPECT_LE(times[4].cooldown_remaining_ms, 1000);
+
+  result = sony_odIsScentEmissionAvailable("200", b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_FALSE(b_is_available);
+  result = sony_odWaitScentEmissionAvailable("200", 2000, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_TRUE(b_is_available);
+
+  result = sony_odEndSession("200");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // The cooldowns must match the channels
+  json_file.open(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "200", "ip": "127.0.0.1", "channels": [0, 1, 2], "cooldown": [0.5], "motor": 0}]})";
+  json_file.close();
+  result = sony_odLoadDeviceConfig(json_path);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  // Restore the installed device.json for the other test cases
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+
+// Counts the messages delivered by the asynchronous log
+std::atomic<int> g_async_log_count{0};
+std::atomic<int> g_async_log_dropped{0};
+std::atomic<bool> g_async_log_on_caller{false};
+std::thread::id g_async_log_caller;
+
+void SlowAsyncLogCallback(const char* message, OdLogLevel /*level*/) {
+  if (std::this_thread::get_id() == g_async_log_caller) {
+    g_async_log_on_caller = true;
+  }
+  if (std::strstr(message, "dropped") != nullptr) {
+    g_async_log_dropped++;
+  }
+  g_async_log_count++;
+  std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+// Test case to log from a background thread without blocking the API calls
+TEST_F(TestOlfactoryDevice, 16_async_log) {
+  g_async_log_caller = std::this_thread::get_id();
+  OdResult result = sony_odRegisterAsyncLogCallback(SlowAsyncLogCallback, OdLogLevel::DEBUG);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odStartSession("0");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // Far more messages than the callback can deliver, the overflow is dropped instead of blocking
+  bool b_is_available = false;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 20000; i++) {
+    result = sony_odStartScentEmission("0", "0", 1.0f, b_is_available);
+    ASSERT_EQ(result, OdResult::SUCCESS);
+  }
+  auto end = std::chrono::steady_clock::now();
+  std::chrono::duration<double> elapsed_seconds = end - start;
+  std::cout << "[unit_test] 20000 calls: " << elapsed_seconds.count() << "seconds" << std::endl;
+
+  result = sony_odEndSession("0");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // Stopping delivers the queued messages
+  result = sony_odRegisterAsyncLogCallback(nullptr, OdLogLevel::DEBUG);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_GT(g_async_log_count, 0);
+  EXPECT_GT(g_async_log_dropped, 0);
+  EXPECT_FALSE(g_async_log_on_caller);
+
+  // The console messages are discarded before being formatted above the INFO level
+  result = sony_odRegisterAsyncLogCallback(SlowAsyncLogCallback, OdLogLevel::OFF);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_FALSE(AsyncLog::GetInstance().IsConsoleEnabled());
+  result = sony_odRegisterAsyncLogCallback(nullptr, OdLogLevel::OFF);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_TRUE(AsyncLog::GetInstance().IsConsoleEnabled());
+}
+
+
+// Test case to read the latency statistics and the counters
+TEST_F(TestOlfactoryDevice, 17_stats) {
+  OdStats stats;
+  OdResult result = sony_odGetStats(stats, true);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odStartSession("0");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // The first emission is sent, the others are rejected during the cooldown
+  bool b_is_available = false;
+  for (int i = 0; i < 10; i++) {
+    result = sony_odStartScentEmission("0", "0", 1.0f, b_is_available);
+    ASSERT_EQ(result, OdResult::SUCCESS);
+  }
+
+  // The calls of a thread which has exited are kept
+  std::thread thread([]() {
+    bool is_available = false;
+    for (int i = 0; i < 100; i++) {
+      sony_odIsScentEmissionAvailable("0", is_available);
+    }
+  });
+  thread.join();
+
+  result = sony_odEndSession("0");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  result = sony_odGetStats(stats, true);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  const OdLatencyStats& emission = stats.latency[static_cast<int32_t>(OdStatsApi::START_SCENT_EMISSION)];
+  EXPECT_EQ(emission.count, 10);
+  EXPECT_GT(emission.max_ns, 0);
+  EXPECT_LE(emission.p50_ns, emission.p99_ns);
+  EXPECT_LE(emission.p99_ns, emission.max_ns);
+  EXPECT_EQ(stats.latency[static_cast<int32_t>(OdStatsApi::IS_SCENT_EMISSION_AVAILABLE)].count, 100);
+  EXPECT_EQ(stats.latency[static_cast<int32_t>(OdStatsApi::START_SESSION)].count, 1);
+  EXPECT_EQ(stats.latency[static_cast<int32_t>(OdStatsApi::SEND_DATA)].count, 3);
+  EXPECT_EQ(stats.sent_commands, 5);
+  EXPECT_EQ(stats.cooldown_rejections, 9);
+  EXPECT_EQ(stats.send_failures, 0);
+  std::cout << "[unit_test] StartScentEmission p50: " << emission.p50_ns << "ns, p99: " << emission.p99_ns
+            << "ns" << std::endl;
+
+  // The previous call has reset the statistics
+  result = sony_odGetStats(stats, false);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_EQ(stats.latency[static_cast<int32_t>(OdStatsApi::START_SCENT_EMISSION)].count, 0);
+  EXPECT_EQ(stats.sent_commands, 0);
+  EXPECT_EQ(stats.size, sizeof(OdStats));
+  EXPECT_EQ(stats.api_count, static_cast<uint32_t>(OdStatsApi::COUNT));
+
+  // A caller built against a smaller structure receives only the fields it knows
+  stats.size = offsetof(OdStats, sent_commands);
+  stats.sent_commands = 12345;
+  result = sony_odGetStats(stats, false);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_EQ(stats.size, offsetof(OdStats, sent_commands));
+  EXPECT_EQ(stats.sent_commands, 12345);
+
+  stats.size = 0;
+  result = sony_odGetStats(stats, false);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+}
+
+
+// Test case to start and end the sessions of several devices at once
+TEST_F(TestOlfactoryDevice, 18_bulk_sessions) {
+  const char* device_ids[] = {"0", "1", "2", "3", "4", "5", "6", "7", "not_exist"};
+  const int32_t count = 9;
+  OdResult results[count];
+
+  // The unknown device fails without affecting the others
+  OdResult result = sony_odStartSessions(device_ids, count, 4, results);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+  for (int32_t i = 0; i < count - 1; i++) {
+    EXPECT_EQ(results[i], OdResult::SUCCESS);
+  }
+  EXPECT_EQ(results[count - 1], OdResult::ERROR_UNKNOWN);
+
+  bool b_is_available = false;
+  for (int32_t i = 0; i < count - 1; i++) {
+    result = sony_odIsScentEmissionAvailable(device_ids[i], b_is_available);
+    EXPECT_EQ(result, OdResult::SUCCESS);
+  }
+
+  result = sony_odEndSessions(device_ids, count - 1, 0, results);
+  EXPECT_EQ(result, OdResult::SUCCESS);
+  result = sony_odIsScentEmissionAvailable(device_ids[0], b_is_available);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+}
+
+
+// Test case to start the emissions of several devices in one call
+TEST_F(TestOlfactoryDevice, 19_batch_emission) {
+  const char* device_ids[] = {"0", "1", "2"};
+  OdResult result = sony_odStartSessions(device_ids, 3, 0, nullptr);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  OdScentEmission emissions[] = {
+      {"0", 0, 1.0f},          // Sent
+      {"1", 0, 1.0f},          // Sent
+      {"2", 1, 1.0f},          // Sent
+      {"0", 0, 1.0f},          // Rejected, the scent is emitted by the first entry
+      {"not_exist", 0, 1.0f},  // Unknown device
+      {"0", 7, 1.0f},          // Unknown scent
+  };
+  const int32_t count = 6;
+  bool is_available[count];
+  OdResult results[count];
+  result = sony_odStartScentEmissions(emissions, count, 0, is_available, results);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+
+  const bool expected_available[count] = {true, true, true, false, false, false};
+  const OdResult expected_results[count] = {OdResult::SUCCESS,       OdResult::SUCCESS,
+                                            OdResult::SUCCESS,       OdResult::SUCCESS,
+                                            OdResult::ERROR_UNKNOWN, OdResult::ERROR_UNKNOWN};
+  for (int32_t i = 0; i < count; i++) {
+    EXPECT_EQ(is_available[i], expected_available[i]) << "entry " << i;
+    EXPECT_EQ(results[i], expected_results[i]) << "entry " << i;
+  }
+
+  // The batch shares the cooldowns of the single emission API
+  bool b_is_available = true;
+  result = sony_odIsScentEmissionAvailable("0", b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_FALSE(b_is_available);
+  result = sony_odStartScentEmissions(emissions, 3, 2, is_available, results);
+  EXPECT_EQ(result, OdResult::SUCCESS);
+  EXPECT_FALSE(is_available[0]);
+  EXPECT_FALSE(is_available[1]);
+  EXPECT_FALSE(is_available[2]);
+
+  result = sony_odEndSessions(device_ids, 3, 0, nullptr);
+  EXPECT_EQ(result, OdResult::SUCCESS);
+}
+
+
+// Test case to send the OSC packets of several sessions with one flush
+TEST_F(TestOlfactoryDevice, 20_udp_transmit_batch) {
+  LoopbackListener listener;
+  UdpListeningReceiveSocket receive_socket(IpEndpointName("127.0.0.1", OSC_PORT), &listener);
+  std::thread receive_thread([&receive_socket]() { receive_socket.Run(); });
+
+  OscSession sessions[3];
+  for (auto& session : sessions) {
+    ASSERT_TRUE(session.Open("127.0.0.1"));
+  }
+
+  // Nothing is sent until the batch is flushed
+  UdpTransmitBatch batch;
+  {
+    UdpTransmitBatch::Scope scope(batch);
+    EXPECT_EQ(UdpTransmitBatch::Current(), &batch);
+    for (auto& session : sessions) {
+      ASSERT_TRUE(session.SendData({CommandOpcode::RELEASE, 0, 0}));
+    }
+    ASSERT_TRUE(sessions[0].SendDataBatch({{CommandOpcode::MOTOR, 0, 30}, {CommandOpcode::MOTOR, 1, 30}}));
+  }
+  EXPECT_EQ(UdpTransmitBatch::Current(), nullptr);
+  EXPECT_EQ(batch.Size(), 4u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(listener.received, 0);
+
+  EXPECT_EQ(batch.Flush(), 0u);
+  EXPECT_EQ(batch.Size(), 0u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(listener.received, 4);
+
+  // Without a batch the packets are sent directly
+  ASSERT_TRUE(sessions[1].SendData({CommandOpcode::RELEASE, 0, 0}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(listener.received, 5);
+
+  // The datagrams which could not be sent are reported with the tag of their scope
+  for (int32_t tag = 0; tag < 3; tag++) {
+    UdpTransmitBatch::Scope scope(batch, tag);
+    ASSERT_TRUE(sessions[tag].SendData({CommandOpcode::RELEASE, 0, 0}));
+    if (tag == 1) {
+      batch.Add(IpEndpointName("127.0.0.1", 0), "x", 1);
+    }
+  }
+  std::vector<int32_t> failed_tags;
+  EXPECT_EQ(batch.Flush(&failed_tags), 1u);
+  EXPECT_EQ(failed_tags, std::vector<int32_t>({1}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(listener.received, 8);
+
+  for (auto& session : sessions) {
+    session.Close();
+  }
+  receive_socket.AsynchronousBreak();
+  receive_thread.join();
+}
+
+
+#ifdef __linux__
+// Test case to send and receive through io_uring, over UDP and over a serial port
+TEST_F(TestOlfactoryDevice, 21_uring_session) {
+  LoopbackListener listener;
+  UdpListeningReceiveSocket receive_socket(IpEndpointName("127.0.0.1", OSC_PORT), &listener);
+  std::thread receive_thread([&receive_socket]() { receive_socket.Run(); });
+
+  // OSC bundles over UDP, the batch fits in one datagram
+  UringSession osc_session;
+  ASSERT_TRUE(osc_session.Open("127.0.0.1"));
+  ASSERT_TRUE(osc_session.SendData({CommandOpcode::RELEASE, 0, 0}));
+  ASSERT_TRUE(osc_session.SendDataBatch({{CommandOpcode::MOTOR, 0, 30}, {CommandOpcode::MOTOR, 1, 30}}));
+  osc_session.Close();
+  EXPECT_FALSE(osc_session.IsConnected());
+  EXPECT_FALSE(osc_session.SendData({CommandOpcode::RELEASE, 0, 0}));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(listener.received, 2);
+  receive_socket.AsynchronousBreak();
+  receive_thread.join();
+
+  // ASCII text over a pseudo terminal standing in for the serial port
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  ASSERT_GE(master, 0);
+  ASSERT_EQ(grantpt(master), 0);
+  ASSERT_EQ(unlockpt(master), 0);
+  UringSession serial_session;
+  ASSERT_TRUE(serial_session.Open(ptsname(master)));
+  ASSERT_TRUE(serial_session.SendDataBatch({{CommandOpcode::RELEASE, 0, 3}, {CommandOpcode::RELEASE, 1, 3}}));
+
+  std::string text;
+  char buffer[64];
+  while (text.size() < strlen("release(0, 3)release(1, 3)")) {
+    ssize_t length = read(master, buffer, sizeof(buffer));
+    ASSERT_GT(length, 0);
+    text.append(buffer, length);
+  }
+  EXPECT_EQ(text, "release(0, 3)release(1, 3)");
+
+  ASSERT_EQ(write(master, "ok", 2), 2);
+  std::string data;
+  ASSERT_TRUE(serial_session.RecvData(data));
+  EXPECT_EQ(data, "ok");
+
+  // Closing cancels the outstanding receive
+  serial_session.Close();
+  EXPECT_FALSE(serial_session.RecvData(data));
+  close(master);
+}
+#endif
+
+
+#ifdef __linux__
+// Test case to send and receive over serial ports, with pseudo terminals standing in for the devices
+TEST_F(TestOlfactoryDevice, 22_uart_session_posix) {
+  const int ports = 2;
+  int masters[ports];
+  UartSession sessions[ports];
+  for (int i = 0; i < ports; i++) {
+    masters[i] = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(masters[i], 0);
+    ASSERT_EQ(grantpt(masters[i]), 0);
+    ASSERT_EQ(unlockpt(masters[i]), 0);
+    ASSERT_TRUE(sessions[i].Open(ptsname(masters[i])));
+  }
+
+  // Commands are written as ASCII text
+  ASSERT_TRUE(sessions[0].SendDataBatch({{CommandOpcode::RELEASE, 0, 3}, {CommandOpcode::RELEASE, 1, 3}}));
+  std::string text;
+  char buffer[64];
+  while (text.size() < strlen("release(0, 3)release(1, 3)")) {
+    ssize_t length = read(masters[0], buffer, sizeof(buffer));
+    ASSERT_GT(length, 0);
+    text.append(buffer, length);
+  }
+  EXPECT_EQ(text, "release(0, 3)release(1, 3)");
+
+  // One reader thread serves both ports
+  ASSERT_EQ(write(masters[1], "one\n", 4), 4);
+  ASSERT_EQ(write(masters[0], "zero\n", 5), 5);
+  std::string data;
+  ASSERT_TRUE(sessions[0].RecvData(data));
+  EXPECT_EQ(data, "zero");
+  ASSERT_TRUE(sessions[1].RecvData(data));
+  EXPECT_EQ(data, "one");
+
+  // A waiting RecvData returns when the session is closed
+  std::thread closer([&sessions]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    sessions[0].Close();
+  });
+  EXPECT_FALSE(sessions[0].RecvData(data));
+  closer.join();
+
+  // A port which hangs up is closed by the reader
+  close(masters[1]);
+  EXPECT_FALSE(sessions[1].RecvData(data));
+  sessions[1].Close();
+  close(masters[0]);
+}
+#endif
+
+
+// Test case to reassemble frames split across reads
+TEST_F(TestOlfactoryDevice, 23_frame_receiver) {
+  auto feed = [](FrameReceiver& receiver, const std::string& data) {
+    size_t size = 0;
+    char* buffer = receiver.WritePointer(size);
+    ASSERT_GE(size, data.size());
+    memcpy(buffer, data.data(), data.size());
+    receiver.Commit(data.size());
+  };
+  std::string_view frame;
+
+  // Text frames, split and joined in any way, with "\n" or "\r\n"
+  FrameReceiver text(FrameMode::NEWLINE, 64);
+  feed(text, "ok(0");
+  EXPECT_FALSE(text.Next(frame));
+  feed(text, ")\r\nerror(1)\n\nbusy");
+  ASSERT_TRUE(text.Next(frame));
+  EXPECT_EQ(frame, "ok(0)");
+  ASSERT_TRUE(text.Next(frame));
+  EXPECT_EQ(frame, "error(1)");
+  EXPECT_FALSE(text.Next(frame));
+  feed(text, "(2)\n");
+  ASSERT_TRUE(text.Next(frame));
+  EXPECT_EQ(frame, "busy(2)");
+  EXPECT_FALSE(text.Next(frame));
+
+  // Many frames through a small buffer
+  for (int i = 0; i < 100; i++) {
+    feed(text, "frame" + std::to_string(i) + "\n");
+    ASSERT_TRUE(text.Next(frame));
+    EXPECT_EQ(frame, "frame" + std::to_string(i));
+    EXPECT_FALSE(text.Next(frame));
+  }
+
+  // A frame larger than the buffer is dropped up to its newline
+  feed(text, std::string(40, 'x'));
+  EXPECT_FALSE(text.Next(frame));
+  feed(text, std::string(24, 'x'));
+  EXPECT_FALSE(text.Next(frame));
+  feed(text, "xx\nnext\n");
+  ASSERT_TRUE(text.Next(frame));
+  EXPECT_EQ(frame, "next");
+  EXPECT_EQ(text.Dropped(), 67u);
+
+  // Binary frames preceded by a 16-bit big-endian length
+  FrameReceiver binary(FrameMode::LENGTH_PREFIXED, 64);
+  feed(binary, std::string("\x00\x03" "ab", 4));
+  EXPECT_FALSE(binary.Next(frame));
+  feed(binary, std::string("\n\x00\x00\x00\x01\n", 6));
+  ASSERT_TRUE(binary.Next(frame));
+  EXPECT_EQ(frame, std::string_view("ab\n", 3));
+  ASSERT_TRUE(binary.Next(frame));
+  EXPECT_EQ(frame.size(), 0u);
+  ASSERT_TRUE(binary.Next(frame));
+  EXPECT_EQ(frame, "\n");
+  EXPECT_FALSE(binary.Next(frame));
+
+  // A frame larger than the buffer is skipped by its length
+  feed(binary, std::string("\x00\x64", 2) + std::string(50, 'y'));
+  EXPECT_FALSE(binary.Next(frame));
+  feed(binary, std::string(50, 'y') + std::string("\x00\x02ok", 4));
+  ASSERT_TRUE(binary.Next(frame));
+  EXPECT_EQ(frame, "ok");
+  EXPECT_EQ(binary.Dropped(), 102u);
+}
+
+
+// Test case to coalesce the queued UART commands into few writes
+TEST_F(TestOlfactoryDevice, 24_uart_write_queue) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool blocked = true;
+  std::vector<std::string> writes;
+  UartWriteQueue queue([&](const char* data, size_t size) {
+    std::unique_lock<std::mutex> lock(mutex);
+    writes.emplace_back(data, size);
+    cv.notify_all();
+    cv.wait(lock, [&blocked]() { return !blocked; });
+    return true;
+  });
+
+  // The first command is written alone, then the writer thread is held in the write
+  ASSERT_TRUE(queue.Push({CommandOpcode::RELEASE, 0, 0}));
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&writes]() { return writes.size() == 1; });
+  }
+
+  // The callers return while the port is busy
+  const int producers = 4;
+  const int commands = 100;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < producers; t++) {
+    threads.emplace_back([&queue, t]() {
+      for (int i = 0; i < commands; i++) {
+        EXPECT_TRUE(queue.Push({CommandOpcode::RELEASE, t, i}));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    blocked = false;
+  }
+  cv.notify_all();
+  EXPECT_TRUE(queue.Flush());
+
+  // Everything pending was written at once, in the order of each caller
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(writes.size(), 2u);
+    EXPECT_EQ(writes[0], "release(0, 0)");
+    for (int t = 0; t < producers; t++) {
+      size_t position = 0;
+      for (int i = 0; i < commands; i++) {
+        std::string command = "release(" + std::to_string(t) + ", " + std::to_string(i) + ")";
+        position = writes[1].find(command, position);
+        ASSERT_NE(position, std::string::npos) << command;
+      }
+    }
+  }
+
+  // A full ring buffer makes the caller wait instead of dropping commands
+  size_t expected = 0;
+  for (int i = 0; i < 4 * UART_WRITE_QUEUE_SIZE; i++) {
+    ASSERT_TRUE(queue.Push({CommandOpcode::RELEASE, 1, i}));
+    expected += strlen("release(1, )") + std::to_string(i).size();
+  }
+  EXPECT_TRUE(queue.Flush());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t written = 0;
+    for (size_t i = 2; i < writes.size(); i++) {
+      written += writes[i].size();
+    }
+    EXPECT_EQ(written, expected);
+  }
+
+  // Stop() writes the remaining commands and refuses the later ones
+  queue.Stop();
+  EXPECT_FALSE(queue.Push({CommandOpcode::RELEASE, 0, 0}));
+
+  // A failed write is reported by Flush()
+  UartWriteQueue failing([](const char*, size_t) { return false; });
+  ASSERT_TRUE(failing.Push({CommandOpcode::RELEASE, 0, 0}));
+  EXPECT_FALSE(failing.Flush());
+  EXPECT_EQ(failing.Failures(), 1u);
+}
+
+
+// Test case to encode the commands as binary frames and negotiate them with the device
+TEST_F(TestOlfactoryDevice, 25_uart_binary_protocol) {
+  DeviceCommand command;
+  uint8_t sequence = 0;
+  auto decode = [&](UartFrameDecoder& decoder, const char* data, size_t size) {
+    int frames = 0;
+    for (size_t i = 0; i < size; i++) {
+      frames += decoder.Push(static_cast<uint8_t>(data[i]), command, sequence) ? 1 : 0;
+    }
+    return frames;
+  };
+
+  // A command takes 7 bytes instead of 12 to 15 as text
+  char frame[UART_FRAME_SIZE];
+  ASSERT_EQ(EncodeCommand(UartProtocol::BINARY, {CommandOpcode::MOTOR, 1, -300}, 9, frame, sizeof(frame)), 7);
+  UartFrameDecoder decoder;
+  ASSERT_EQ(decode(decoder, frame, sizeof(frame)), 1);
+  EXPECT_EQ(command.opcode, CommandOpcode::MOTOR);
+  EXPECT_EQ(command.target, 1);
+  EXPECT_EQ(command.level, -300);
+  EXPECT_EQ(sequence, 9);
+  char text[64];
+  EXPECT_EQ(EncodeCommand(UartProtocol::TEXT, {CommandOpcode::RELEASE, 0, 3}, 0, text, sizeof(text)), 13);
+  EXPECT_STREQ(text, "release(0, 3)");
+
+  // Commands out of the range of the frame are refused
+  EXPECT_FALSE(FitsBinaryFrame({CommandOpcode::RELEASE, 256, 3}));
+  EXPECT_EQ(EncodeCommand(UartProtocol::BINARY, {CommandOpcode::RELEASE, 0, 40000}, 0, frame, 7), -1);
+
+  // A corrupted frame is rejected, the next frame is found again and the gap is counted
+  std::string stream;
+  for (uint8_t i = 10; i < 14; i++) {
+    EncodeCommand(UartProtocol::BINARY, {CommandOpcode::RELEASE, i, 3}, i, frame, sizeof(frame));
+    stream.append(frame, sizeof(frame));
+  }
+  stream[UART_FRAME_SIZE + 3] ^= 0x10;
+  stream.erase(2 * UART_FRAME_SIZE, UART_FRAME_SIZE);
+  EXPECT_EQ(decode(decoder, stream.data(), stream.size()), 2);
+  EXPECT_EQ(command.target, 13);
+  EXPECT_EQ(decoder.Errors(), 1u);
+  EXPECT_EQ(decoder.Lost(), 2u);
+
+#ifdef __linux__
+  // The device accepts the binary protocol requested at Open()
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  ASSERT_GE(master, 0);
+  ASSERT_EQ(grantpt(master), 0);
+  ASSERT_EQ(unlockpt(master), 0);
+  std::thread device([master]() {
+    std::string request;
+    char buffer[64];
+    while (request.find(UART_PROTOCOL_REQUEST) == std::string::npos) {
+      ssize_t length = read(master, buffer, sizeof(buffer));
+      ASSERT_GT(length, 0);
+      request.append(buffer, length);
+    }
+    const char reply[] = "ready\n" UART_PROTOCOL_ACCEPTED "\n";
+    ASSERT_EQ(write(master, reply, sizeof(reply) - 1), static_cast<ssize_t>(sizeof(reply) - 1));
+  });
+  UartSession session;
+  session.SetProtocol(UartProtocol::BINARY);
+  ASSERT_TRUE(session.Open(ptsname(master)));
+  device.join();
+  EXPECT_EQ(session.Protocol(), UartProtocol::BINARY);
+
+  // The commands arrive as numbered frames
+  ASSERT_TRUE(session.SendDataBatch({{CommandOpcode::RELEASE, 0, 3}, {CommandOpcode::MOTOR, 0, 30}}));
+  ASSERT_TRUE(session.SendData({CommandOpcode::RESET, 0, 0}));
+  EXPECT_TRUE(session.Flush());
+  std::string received;
+  char buffer[64];
+  while (received.size() < 3 * UART_FRAME_SIZE) {
+    ssize_t length = read(master, buffer, sizeof(buffer));
+    ASSERT_GT(length, 0);
+    received.append(buffer, length);
+  }
+  UartFrameDecoder device_decoder;
+  EXPECT_EQ(decode(device_decoder, received.data(), received.size()), 3);
+  EXPECT_EQ(command.opcode, CommandOpcode::RESET);
+  EXPECT_EQ(sequence, 2);
+  EXPECT_EQ(device_decoder.Errors(), 0u);
+  EXPECT_EQ(device_decoder.Lost(), 0u);
+  session.Close();
+
+  // A device which does not reply keeps the text protocol
+  ASSERT_TRUE(session.Open(ptsname(master)));
+  EXPECT_EQ(session.Protocol(), UartProtocol::TEXT);
+  session.Close();
+  close(master);
+#endif
+}
+
+
+// Test case to emit at a future time, with an OSC time tag or from the scheduler thread
+TEST_F(TestOlfactoryDevice, 26_scheduled_emission) {
+  // OSC bundles carry the time of the commands as an NTP time tag
+  LoopbackListener listener;
+  UdpListeningReceiveSocket receive_socket(IpEndpointName("127.0.0.1", OSC_PORT), &listener);
+  std::thread receive_thread([&receive_socket]() { receive_socket.Run(); });
+  OscSession osc;
+  ASSERT_TRUE(osc.Open("127.0.0.1"));
+  EXPECT_TRUE(osc.SupportsTimeTags());
+  auto time = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+  ASSERT_TRUE(osc.SendDataAt({{CommandOpcode::RELEASE, 0, 3}}, time));
+  for (int i = 0; i < 200 && listener.received < 1; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(listener.received, 1);
+  int64_t error = static_cast<int64_t>(listener.time_tag - ToOscTimeTag(time));
+  EXPECT_LT(std::abs(error), (1LL << 32) / 1000);  // 1 ms
+  int64_t unix_seconds = static_cast<int64_t>(listener.time_tag >> 32) - 2208988800LL;
+  EXPECT_LE(std::abs(unix_seconds - static_cast<int64_t>(::time(nullptr))), 2);
+  osc.Close();
+  receive_socket.AsynchronousBreak();
+  receive_thread.join();
+
+  // The stub session has no time tags, the command is sent by the scheduler thread at the time
+  const char* device_id = "0";
+  ASSERT_EQ(sony_odStartSession(device_id), OdResult::SUCCESS);
+  OdStats before;
+  ASSERT_EQ(sony_odGetStats(before, false), OdResult::SUCCESS);
+  int64_t now_us = 0;
+  ASSERT_EQ(sony_odGetTime(now_us), OdResult::SUCCESS);
+  bool is_available = false;
+  ASSERT_EQ(sony_odScheduleScentEmission(device_id, "0", 1.0f, now_us + 500000, is_available),
+            OdResult::SUCCESS);
+  EXPECT_TRUE(is_available);
+
+  // The scent is reserved from the call until the end of the cooldown of the scheduled emission
+  ASSERT_EQ(sony_odScheduleScentEmission(device_id, "0", 1.0f, now_us + 600000, is_available),
+            OdResult::SUCCESS);
+  EXPECT_FALSE(is_available);
+  OdStats stats;
+  ASSERT_EQ(sony_odGetStats(stats, false), OdResult::SUCCESS);
+  EXPECT_EQ(stats.sent_commands, before.sent_commands);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(700));
+  ASSERT_EQ(sony_odGetStats(stats, false), OdResult::SUCCESS);
+  EXPECT_EQ(stats.sent_commands, before.sent_commands + 1);
+
+  // Ending the session cancels the emissions not sent yet, only the motor commands are sent
+  ASSERT_EQ(sony_odGetTime(now_us), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odScheduleScentEmission(device_id, "1", 1.0f, now_us + 300000, is_available),
+            OdResult::SUCCESS);
+  EXPECT_TRUE(is_available);
+
+  // Times out of the range of the clock neither overflow nor send anything
+  EXPECT_EQ(sony_odScheduleScentEmission(device_id, "1", 1.0f, INT64_MAX, is_available),
+            OdResult::ERROR_UNKNOWN);
+  EXPECT_FALSE(is_available);
+  ASSERT_EQ(sony_odScheduleScentEmission(device_id, "1", 1.0f, INT64_MIN, is_available), OdResult::SUCCESS);
+  EXPECT_FALSE(is_available);
+  ASSERT_EQ(sony_odEndSession(device_id), OdResult::SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  ASSERT_EQ(sony_odGetStats(stats, false), OdResult::SUCCESS);
+  EXPECT_EQ(stats.sent_commands, before.sent_commands + 3);
+}
+
+
+// Test case to release the emissions of several devices together
+TEST_F(TestOlfactoryDevice, 27_group_emission) {
+  const char* device_ids[] = {"0", "2", "4"};
+  OdResult result = sony_odStartSessions(device_ids, 3, 0, nullptr);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  OdScentEmission emissions[] = {
+      {"0", 0, 1.0f},          // Sent
+      {"2", 0, 1.0f},          // Sent
+      {"4", 1, 1.0f},          // Sent
+      {"2", 0, 1.0f},          // Rejected, the scent is emitted by the second entry
+      {"not_exist", 0, 1.0f},  // Unknown device
+  };
+  const int32_t count = 5;
+  bool is_available[count];
+  OdResult results[count];
+  int64_t before_us = 0;
+  ASSERT_EQ(sony_odGetTime(before_us), OdResult::SUCCESS);
+  OdGroupEmission group;
+  result = sony_odStartGroupScentEmission(emissions, count, is_available, results, group);
+  EXPECT_EQ(result, OdResult::ERROR_UNKNOWN);
+  int64_t after_us = 0;
+  ASSERT_EQ(sony_odGetTime(after_us), OdResult::SUCCESS);
+
+  const bool expected_available[count] = {true, true, true, false, false};
+  const OdResult expected_results[count] = {OdResult::SUCCESS, OdResult::SUCCESS, OdResult::SUCCESS,
+                                            OdResult::SUCCESS, OdResult::ERROR_UNKNOWN};
+  for (int32_t i = 0; i < count; i++) {
+    EXPECT_EQ(is_available[i], expected_available[i]) << "entry " << i;
+    EXPECT_EQ(results[i], expected_results[i]) << "entry " << i;
+  }
+
+  // The three addresses are released together. The stub sessions have no time tags.
+  EXPECT_EQ(group.devices, 3);
+  EXPECT_FALSE(group.time_tagged);
+  EXPECT_GE(group.start_us, before_us);
+  EXPECT_LE(group.start_us, after_us);
+  EXPECT_GE(group.skew_us, 0);
+  EXPECT_LE(group.skew_us, after_us - before_us);
+
+  // The group shares the cooldowns of the other emission APIs
+  result = sony_odStartGroupScentEmission(emissions, 3, is_available, results, group);
+  EXPECT_EQ(result, OdResult::SUCCESS);
+  EXPECT_FALSE(is_available[0]);
+  EXPECT_FALSE(is_available[1]);
+  EXPECT_FALSE(is_available[2]);
+  EXPECT_EQ(group.devices, 0);
+
+  result = sony_odEndSessions(device_ids, 3, 0, nullptr);
+  EXPECT_EQ(result, OdResult::SUCCESS);
+}
+
+
+// Test case to measure how late the scheduler thread sends the scheduled commands
+TEST_F(TestOlfactoryDevice, 28_scheduler_firing_error) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "127.0.0.1", "channels": [0, 1], "cooldown": 0, "motor": 0}]})";
+  json_file.close();
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  int32_t handle = -1;
+  ASSERT_EQ(sony_odGetDeviceHandle("100", handle), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSessionByHandle(handle), OdResult::SUCCESS);
+
+  OdStats stats;
+  ASSERT_EQ(sony_odGetStats(stats, true), OdResult::SUCCESS);
+  int64_t now_us = 0;
+  ASSERT_EQ(sony_odGetTime(now_us), OdResult::SUCCESS);
+  const int32_t count = 10;
+  for (int32_t i = 0; i < count; i++) {
+    bool is_available = false;
+    int64_t time_us = now_us + 50000 + i * 20000;
+    ASSERT_EQ(sony_odScheduleScentEmissionByHandle(handle, i % 2, 0.0f, time_us, is_available), OdResult::SUCCESS);
+    EXPECT_TRUE(is_available) << "emission " << i;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50 + count * 20 + 100));
+
+  // Every command is sent once its time is reached, the spin keeps the delay well below the OS tick
+  ASSERT_EQ(sony_odGetStats(stats, false), OdResult::SUCCESS);
+  const OdLatencyStats& firing = stats.latency[static_cast<int32_t>(OdStatsApi::SCHEDULED_FIRING)];
+  EXPECT_EQ(firing.count, static_cast<uint64_t>(count));
+  EXPECT_EQ(stats.sent_commands, static_cast<uint64_t>(count));
+  EXPECT_LT(firing.p50_ns, 2000000u);
+  EXPECT_LT(firing.max_ns, 50000000u);
+
+  ASSERT_EQ(sony_odEndSessionByHandle(handle), OdResult::SUCCESS);
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+
+// Test case to expire timers of every level of the timing wheel on their tick
+TEST_F(TestOlfactoryDevice, 29_timing_wheel) {
+  auto origin = std::chrono::steady_clock::now();
+  TimingWheel<int32_t> wheel(origin);
+
+  // Timers from the first level up to the third one, each expiring on its own millisecond
+  std::mt19937 random(29);
+  std::uniform_int_distribution<int64_t> delays(0, 300000);
+  const int32_t count = 2000;
+  std::vector<int64_t> times_ms(count);
+  std::vector<TimingWheel<int32_t>::TimerId> ids(count);
+  for (int32_t i = 0; i < count; i++) {
+    times_ms[i] = 1 + delays(random);
+    ids[i] = wheel.Add(origin + std::chrono::milliseconds(times_ms[i]), i, origin);
+  }
+  EXPECT_EQ(wheel.Size(), static_cast<size_t>(count));
+
+  // Cancelled timers never expire, and cannot be cancelled twice
+  for (int32_t i = 0; i < count; i += 10) {
+    EXPECT_TRUE(wheel.Cancel(ids[i]));
+    EXPECT_FALSE(wheel.Cancel(ids[i]));
+  }
+  EXPECT_EQ(wheel.Size(), static_cast<size_t>(count - count / 10));
+
+  // Advance by uneven steps, each timer expires in the step which reaches its time
+  std::vector<int32_t> expired(count, 0);
+  std::uniform_int_distribution<int64_t> steps(0, 3000);
+  int64_t now_ms = 0;
+  while (wheel.Size() > 0) {
+    int64_t previous_ms = now_ms;
+    now_ms += steps(random);
+    auto wakeup = wheel.NextWakeup();
+    EXPECT_GT(wakeup, origin + std::chrono::milliseconds(previous_ms));
+    wheel.Advance(origin + std::chrono::milliseconds(now_ms),
+                  [&](TimingWheel<int32_t>::TimerId id, int32_t value) {
+                    EXPECT_EQ(id, ids[value]);
+                    EXPECT_GT(times_ms[value], previous_ms) << "timer " << value;
+                    EXPECT_LE(times_ms[value], now_ms) << "timer " << value;
+                    expired[value]++;
+                  });
+    ASSERT_LT(now_ms, 400000);
+  }
+  for (int32_t i = 0; i < count; i++) {
+    EXPECT_EQ(expired[i], i % 10 == 0 ? 0 : 1) << "timer " << i;
+    EXPECT_FALSE(wheel.Cancel(ids[i]));
+  }
+
+  // A time already passed expires on the next tick, a free node is reused with a new id
+  auto now = origin + std::chrono::milliseconds(now_ms);
+  auto id = wheel.Add(origin, -1, now);
+  EXPECT_EQ(wheel.NextWakeup(), now + std::chrono::milliseconds(1));
+  EXPECT_TRUE(std::find(ids.begin(), ids.end(), id) == ids.end());
+  int32_t late = 0;
+  wheel.Advance(now + std::chrono::milliseconds(1), [&late](TimingWheel<int32_t>::TimerId, int32_t) { late++; });
+  EXPECT_EQ(late, 1);
+
+  // After a long idle period the empty wheel skips to the current time instead of walking the missed ticks
+  auto idle = now + std::chrono::hours(24);
+  wheel.Add(idle + std::chrono::milliseconds(5), -2, idle);
+  EXPECT_EQ(wheel.NextWakeup(), idle + std::chrono::milliseconds(5));
+  auto start = std::chrono::steady_clock::now();
+  wheel.Advance(idle + std::chrono::milliseconds(5),
+                [&late](TimingWheel<int32_t>::TimerId, int32_t) { late++; });
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+  EXPECT_EQ(late, 2);
+  EXPECT_EQ(wheel.Size(), 0u);
+}
+
+
+// Records the emission end callbacks
+std::atomic<int> g_emission_end_count{0};
+std::atomic<int> g_emission_end_scent{-1};
+
+void RecordEmissionEndCallback(const char* device_id, int32_t scent, void* user_data) {
+  if (std::string(device_id) == static_cast<const char*>(user_data)) {
+    g_emission_end_scent = scent;
+    g_emission_end_count++;
+  }
+}
+
+// Test case to report the end of the emissions from the timer thread
+TEST_F(TestOlfactoryDevice, 30_emission_end_callback) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "127.0.0.1", "channels": [0, 1], "cooldown": 0, "motor": 0}]})";
+  json_file.close();
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  static const char kDeviceId[] = "100";
+  ASSERT_EQ(sony_odRegisterEmissionEndCallback(RecordEmissionEndCallback, const_cast<char*>(kDeviceId)),
+            OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSession(kDeviceId), OdResult::SUCCESS);
+
+  // The callback comes once the duration has passed
+  bool is_available = false;
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(sony_odStartScentEmission(kDeviceId, "1", 0.2f, is_available), OdResult::SUCCESS);
+  for (int i = 0; i < 100 && g_emission_end_count == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  auto end = std::chrono::steady_clock::now();
+  EXPECT_EQ(g_emission_end_count, 1);
+  EXPECT_EQ(g_emission_end_scent, 1);
+  EXPECT_GE(end - start, std::chrono::milliseconds(200));
+
+  // A stopped emission ends at once and does not report its end
+  ASSERT_EQ(sony_odStartScentEmission(kDeviceId, "0", 0.2f, is_available), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStopScentEmission(kDeviceId), OdResult::SUCCESS);
+  OdScentTime times[2];
+  int32_t count = 0;
+  ASSERT_EQ(sony_odGetScentEmissionTimes(kDeviceId, times, 2, count), OdResult::SUCCESS);
+  EXPECT_EQ(times[0].emission_remaining_ms, 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(g_emission_end_count, 1);
+
+  // Neither does an emission whose session ended
+  ASSERT_EQ(sony_odStartScentEmission(kDeviceId, "0", 0.2f, is_available), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odEndSession(kDeviceId), OdResult::SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(g_emission_end_count, 1);
+
+  sony_odRegisterEmissionEndCallback(nullptr, nullptr);
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+
+// Test case to write a timeline file, map it and play it with pause and seek
+TEST_F(TestOlfactoryDevice, 31_timeline_playback) {
+  const char* path = "unit_test_timeline.odtl";
+
+  // The entries are sorted by time, the device ids are stored once
+  std::vector<TimelineEntry> entries = {
+      {2500000, "2", 1, 0.5f}, {0, "0", 0, 1.0f}, {1000000, "2", 0, 2.0f}, {1000000, "0", 1, 3.0f}};
+  ASSERT_TRUE(TimelineFile::Write(path, entries));
+  TimelineFile file;
+  ASSERT_TRUE(file.Open(path));
+  ASSERT_EQ(file.Count(), 4u);
+  ASSERT_EQ(file.Devices().size(), 2u);
+  EXPECT_EQ(file.Devices()[0], "2");
+  EXPECT_EQ(file.Devices()[1], "0");
+  EXPECT_EQ(file.Record(0).time_us, 0);
+  EXPECT_EQ(file.Record(1).device, 0u);
+  EXPECT_EQ(file.Record(2).device, 1u);
+  EXPECT_EQ(file.Record(2).scent, 1);
+  EXPECT_EQ(file.Record(3).duration, 0.5f);
+  EXPECT_EQ(file.Duration(), 2500000);
+
+  // Seek finds the first record at or after the time, through the index
+  EXPECT_EQ(file.Seek(-1), 0u);
+  EXPECT_EQ(file.Seek(1), 1u);
+  EXPECT_EQ(file.Seek(1000000), 1u);
+  EXPECT_EQ(file.Seek(1000001), 3u);
+  EXPECT_EQ(file.Seek(2500000), 3u);
+  EXPECT_EQ(file.Seek(2500001), 4u);
+  EXPECT_EQ(file.Seek(10000000), 4u);
+  file.Close();
+
+  // Negative times and files which are not timelines are rejected
+  EXPECT_FALSE(TimelineFile::Write(path, {{-1, "0", 0, 1.0f}}));
+  std::ofstream garbage(path, std::ios::binary);
+  garbage << "ODTL not a timeline";
+  garbage.close();
+  EXPECT_FALSE(file.Open(path));
+
+  // One record every 100 ms for 1 s
+  entries.clear();
+  for (int32_t i = 0; i <= 10; i++) {
+    entries.push_back({i * 100000LL, "0", i, 1.0f});
+  }
+  ASSERT_TRUE(TimelineFile::Write(path, entries));
+  std::mutex mutex;
+  std::vector<std::pair<int32_t, int64_t>> emitted;
+  TimelinePlayer player([&](const TimelineRecord& record, int64_t time_us) {
+    std::lock_guard<std::mutex> lock(mutex);
+    emitted.emplace_back(record.scent, time_us);
+  });
+  ASSERT_TRUE(player.Open(path));
+  int64_t position_us = -1;
+  bool is_playing = true;
+  player.Position(position_us, is_playing);
+  EXPECT_EQ(position_us, 0);
+  EXPECT_FALSE(is_playing);
+
+  // Each record is handed out ahead of its time, with the time at which it must start
+  int64_t start_us = 0;
+  sony_odGetTime(start_us);
+  player.Play();
+  std::this_thread::sleep_for(std::chrono::milliseconds(320));
+  player.Pause();
+  player.Position(position_us, is_playing);
+  EXPECT_FALSE(is_playing);
+  EXPECT_GE(position_us, 320000);
+  EXPECT_LT(position_us, 400000);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_GE(emitted.size(), 4u);
+    ASSERT_LE(emitted.size(), 5u);
+    for (size_t i = 0; i < emitted.size(); i++) {
+      EXPECT_EQ(emitted[i].first, static_cast<int32_t>(i));
+      EXPECT_GE(emitted[i].second - start_us, static_cast<int64_t>(i) * 100000);
+      EXPECT_LT(emitted[i].second - start_us, static_cast<int64_t>(i) * 100000 + 20000);
+    }
+  }
+
+  // Nothing more is handed out while paused
+  size_t paused_count = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    paused_count = emitted.size();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  int64_t paused_us = -1;
+  player.Position(paused_us, is_playing);
+  EXPECT_EQ(paused_us, position_us);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(emitted.size(), paused_count);
+    emitted.clear();
+  }
+
+  // After a seek the playback goes on from the new position, and stops at the last record
+  player.Seek(850000);
+  player.Play();
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  player.Position(position_us, is_playing);
+  EXPECT_FALSE(is_playing);
+  EXPECT_EQ(position_us, 1000000);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(emitted.size(), 2u);
+    EXPECT_EQ(emitted[0].first, 9);
+    EXPECT_EQ(emitted[1].first, 10);
+    EXPECT_NEAR(static_cast<double>(emitted[1].second - emitted[0].second), 100000.0, 5000.0);
+  }
+
+  // The API plays the same file on the devices of device.json
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "0", "ip": "127.0.0.1", "channels": [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10], )"
+            << R"("cooldown": 0, "motor": 0}]})";
+  json_file.close();
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSession("0"), OdResult::SUCCESS);
+  OdTimelineEvent events[] = {{0, "0", 0, 0.1f}, {100000, "0", 1, 1.0f}, {150000, "unknown", 0, 0.1f}};
+  ASSERT_EQ(sony_odWriteTimeline(path, events, 3), OdResult::SUCCESS);
+  int32_t timeline = 0;
+  ASSERT_EQ(sony_odOpenTimeline(path, timeline), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odPlayTimeline(timeline), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odGetTimelinePosition(timeline, position_us, is_playing), OdResult::SUCCESS);
+  EXPECT_TRUE(is_playing);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  ASSERT_EQ(sony_odGetTimelinePosition(timeline, position_us, is_playing), OdResult::SUCCESS);
+  EXPECT_FALSE(is_playing);
+  EXPECT_EQ(position_us, 150000);
+  OdScentTime times[11];
+  int32_t count = 0;
+  ASSERT_EQ(sony_odGetScentEmissionTimes("0", times, 11, count), OdResult::SUCCESS);
+  EXPECT_GT(times[1].emission_remaining_ms, 0);
+  ASSERT_EQ(sony_odSeekTimeline(timeline, 50000), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odPauseTimeline(timeline), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odCloseTimeline(timeline), OdResult::SUCCESS);
+  EXPECT_EQ(sony_odPlayTimeline(timeline), OdResult::ERROR_UNKNOWN);
+  EXPECT_EQ(sony_odOpenTimeline("missing.odtl", timeline), OdResult::ERROR_UNKNOWN);
+
+  ASSERT_EQ(sony_odEndSession("0"), OdResult::SUCCESS);
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+  std::remove(path);
+}
+
+// Test case to reload device.json more times than the handle table could hold new entries for
+TEST_F(TestOlfactoryDevice, 32_reload_device_handles) {
+  const int max_devices = 64;
+  const int max_reloads = DEVICE_HANDLE_MAX / max_devices + 1;
+
+  // Writes device.json with the last device at the given address
+  const char* json_path = "unit_test_device.json";
+  auto write_config = [json_path](const char* last_ip) {
+    std::ofstream json_file(json_path);
+    json_file << R"({"device": [)";
+    for (int i = 0; i < max_devices; i++) {
+      json_file << (i == 0 ? "" : ",") << R"({"id": ")" << (300 + i) << R"(", "ip": ")"
+                << (i == max_devices - 1 ? last_ip : "10.0.1.1") << R"(", "scent0": 0, "scent1": 1, "motor": 0})";
+    }
+    json_file << "]}";
+  };
+
+  write_config("10.0.1.2");
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  std::vector<int32_t> handles(max_devices);
+  for (int i = 0; i < max_devices; i++) {
+    ASSERT_EQ(sony_odGetDeviceHandle(std::to_string(300 + i).c_str(), handles[i]), OdResult::SUCCESS);
+  }
+
+  // The devices whose settings did not change keep their handles
+  for (int loop = 0; loop < max_reloads; loop++) {
+    ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+    for (int i = 0; i < max_devices; i++) {
+      int32_t handle = -1;
+      ASSERT_EQ(sony_odGetDeviceHandle(std::to_string(300 + i).c_str(), handle), OdResult::SUCCESS);
+      ASSERT_EQ(handle, handles[i]);
+    }
+  }
+
+  // A device whose settings changed gets a new handle, and the old one keeps the old settings
+  std::string last_id = std::to_string(300 + max_devices - 1);
+  write_config("10.0.1.3");
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  int32_t changed_handle = -1;
+  ASSERT_EQ(sony_odGetDeviceHandle(last_id.c_str(), changed_handle), OdResult::SUCCESS);
+  EXPECT_NE(changed_handle, handles[max_devices - 1]);
+  ASSERT_NE(DeviceHandleTable::GetInstance().Get(handles[max_devices - 1]), nullptr);
+  EXPECT_EQ(DeviceHandleTable::GetInstance().Get(handles[max_devices - 1])->info.ip, "10.0.1.2");
+
+  // Switching between the two settings reuses their entries
+  for (int loop = 0; loop < max_reloads; loop++) {
+    write_config(loop % 2 ? "10.0.1.3" : "10.0.1.2");
+    ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+    int32_t handle = -1;
+    ASSERT_EQ(sony_odGetDeviceHandle(last_id.c_str(), handle), OdResult::SUCCESS);
+    ASSERT_EQ(handle, loop % 2 ? changed_handle : handles[max_devices - 1]);
+  }
+
+  // Restore the installed device.json for the other test cases
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+// Test case to emit on a channel without cooldown, which never becomes unavailable
+TEST_F(TestOlfactoryDevice, 33_emission_without_cooldown) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "127.0.0.1", "scent0": 0, "scent1": 1, "cooldown": 0, "motor": 0}]})";
+  json_file.close();
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+
+  static const char kDeviceId[] = "100";
+  g_available_count = 0;
+  OdResult result = sony_odRegisterAvailabilityCallback(CountAvailableCallback, const_cast<char*>(kDeviceId));
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  result = sony_odStartSession("100");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+
+  // Neither an emission time nor a cooldown: no availability event is scheduled
+  bool b_is_available = false;
+  result = sony_odStartScentEmission("100", "0", 0.0f, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  result = sony_odIsScentEmissionAvailable("100", b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  EXPECT_TRUE(b_is_available);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(g_available_count, 0);
+
+  // An emission time makes the channel unavailable until it ends, which is notified
+  result = sony_odStartScentEmission("100", "0", 0.05f, b_is_available);
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  for (int i = 0; i < 100 && g_available_count == 0; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(g_available_count, 1);
+
+  result = sony_odEndSession("100");
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  sony_odRegisterAvailabilityCallback(nullptr, nullptr);
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+// Test case to end a session through another handle of the device than the one of the scheduled emission
+TEST_F(TestOlfactoryDevice, 34_end_session_cancels_all_handles) {
+  const char* json_path = "unit_test_device.json";
+  auto write_config = [json_path](int motor) {
+    std::ofstream json_file(json_path);
+    json_file << R"({"device": [)"
+              << R"({"id": "100", "ip": "127.0.0.1", "scent0": 0, "scent1": 1, "motor": )" << motor << "}]}";
+  };
+  write_config(0);
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  int32_t old_handle = -1;
+  ASSERT_EQ(sony_odGetDeviceHandle("100", old_handle), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSessionByHandle(old_handle), OdResult::SUCCESS);
+
+  // The reload gives the id a new handle on the same address
+  write_config(1);
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  int32_t new_handle = -1;
+  ASSERT_EQ(sony_odGetDeviceHandle("100", new_handle), OdResult::SUCCESS);
+  ASSERT_NE(old_handle, new_handle);
+
+  OdStats before;
+  ASSERT_EQ(sony_odGetStats(before, false), OdResult::SUCCESS);
+  int64_t now_us = 0;
+  ASSERT_EQ(sony_odGetTime(now_us), OdResult::SUCCESS);
+  bool is_available = false;
+  ASSERT_EQ(sony_odScheduleScentEmissionByHandle(old_handle, 0, 1.0f, now_us + 300000, is_available),
+            OdResult::SUCCESS);
+  EXPECT_TRUE(is_available);
+
+  // The emission scheduled through the old handle is not sent to the next session
+  ASSERT_EQ(sony_odEndSessionByHandle(new_handle), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSessionByHandle(new_handle), OdResult::SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  OdStats stats;
+  ASSERT_EQ(sony_odGetStats(stats, false), OdResult::SUCCESS);
+  EXPECT_EQ(stats.sent_commands, before.sent_commands + 4);  // Motor commands of the end and the start
+
+  ASSERT_EQ(sony_odEndSessionByHandle(new_handle), OdResult::SUCCESS);
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+// Test case to restart a session while the cooldown of the previous session is running
+TEST_F(TestOlfactoryDevice, 35_end_session_cancels_cooldown) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "127.0.0.1", "scent0": 0, "scent1": 1, "cooldown": 0.2, "motor": 0}]})";
+  json_file.close();
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+
+  static const char kDeviceId[] = "100";
+  g_available_count = 0;
+  OdResult result = sony_odRegisterAvailabilityCallback(CountAvailableCallback, const_cast<char*>(kDeviceId));
+  ASSERT_EQ(result, OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSession("100"), OdResult::SUCCESS);
+  bool b_is_available = false;
+  ASSERT_EQ(sony_odStartScentEmission("100", "0", 0.1f, b_is_available), OdResult::SUCCESS);
+
+  // The cooldown of the ended session does not notify the new one
+  ASSERT_EQ(sony_odEndSession("100"), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSession("100"), OdResult::SUCCESS);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(g_available_count, 0);
+
+  ASSERT_EQ(sony_odEndSession("100"), OdResult::SUCCESS);
+  sony_odRegisterAvailabilityCallback(nullptr, nullptr);
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+// Test case to stop a device whose emission is scheduled on the host and not sent yet
+TEST_F(TestOlfactoryDevice, 36_stop_cancels_scheduled_emission) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "127.0.0.1", "scent0": 0, "scent1": 1, "cooldown": 1, "motor": 0}]})";
+  json_file.close();
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStartSession("100"), OdResult::SUCCESS);
+
+  int64_t now_us = 0;
+  ASSERT_EQ(sony_odGetTime(now_us), OdResult::SUCCESS);
+  bool is_available = false;
+  ASSERT_EQ(sony_odScheduleScentEmission("100", "0", 1.0f, now_us + 300000, is_available), OdResult::SUCCESS);
+  EXPECT_TRUE(is_available);
+  ASSERT_EQ(sony_odIsScentEmissionAvailable("100", is_available), OdResult::SUCCESS);
+  EXPECT_FALSE(is_available);
+
+  // The stop sends its release commands only, and the reserved scent is available again
+  OdStats before;
+  ASSERT_EQ(sony_odGetStats(before, false), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odStopScentEmission("100"), OdResult::SUCCESS);
+  ASSERT_EQ(sony_odIsScentEmissionAvailable("100", is_available), OdResult::SUCCESS);
+  EXPECT_TRUE(is_available);
+  std::this_thread::sleep_for(std::chrono::milliseconds(400));
+  OdStats stats;
+  ASSERT_EQ(sony_odGetStats(stats, false), OdResult::SUCCESS);
+  EXPECT_EQ(stats.sent_commands, before.sent_commands + 2);
+
+  ASSERT_EQ(sony_odEndSession("100"), OdResult::SUCCESS);
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
+// Test case to read the serial protocol of the devices from device.json
+TEST_F(TestOlfactoryDevice, 37_device_protocol) {
+  const char* json_path = "unit_test_device.json";
+  std::ofstream json_file(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "COM3", "scent0": 0, "scent1": 1, "motor": 0, "protocol": "binary"},)"
+            << R"({"id": "101", "ip": "COM4", "scent0": 0, "scent1": 1, "motor": 0}]})";
+  json_file.close();
+  ASSERT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::SUCCESS);
+
+  int32_t handle = -1;
+  ASSERT_EQ(sony_odGetDeviceHandle("100", handle), OdResult::SUCCESS);
+  EXPECT_EQ(DeviceHandleTable::GetInstance().Get(handle)->info.protocol, UartProtocol::BINARY);
+  ASSERT_EQ(sony_odGetDeviceHandle("101", handle), OdResult::SUCCESS);
+  EXPECT_EQ(DeviceHandleTable::GetInstance().Get(handle)->info.protocol, UartProtocol::TEXT);
+
+  // An unknown protocol is an error in device.json
+  json_file.open(json_path);
+  json_file << R"({"device": [)"
+            << R"({"id": "100", "ip": "COM3", "scent0": 0, "scent1": 1, "motor": 0, "protocol": "morse"}]})";
+  json_file.close();
+  EXPECT_EQ(sony_odLoadDeviceConfig(json_path), OdResult::ERROR_UNKNOWN);
+
+  sony_odLoadDeviceConfig(nullptr);
+  std::remove(json_path);
+}
+
 }  // namespace